@@ -0,0 +1,91 @@
+#include "Benchmark.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+//---------------------------------------------------------------------------
+using namespace std;
+using namespace pljit::bench;
+//---------------------------------------------------------------------------
+/// Print the usage.
+static void PrintUsage(const char* program) {
+    cerr << "usage: " << program << " [--filter <substring>] [--min-time <ms>] [--repetitions <n>]"
+         << " [--json <path>] [--baseline <path>] [--threshold <percent>] [--perf-counters]" << endl;
+    cerr << "       " << program << " --scaling <max threads> [--duration <ms>] [--json <path>]" << endl;
+}
+//---------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    Harness::Options options;
+    string json_path;
+    string baseline_path;
+    double threshold_percent = 10;
+    size_t scaling_threads = 0;
+    uint64_t duration_ms = 500;
+    for (int i = 1; i < argc; i++) {
+        const bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "--filter") && has_value) {
+            options.filter = argv[++i];
+        } else if (!strcmp(argv[i], "--min-time") && has_value) {
+            options.min_time_ms = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--repetitions") && has_value) {
+            options.repetitions = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--json") && has_value) {
+            json_path = argv[++i];
+        } else if (!strcmp(argv[i], "--baseline") && has_value) {
+            baseline_path = argv[++i];
+        } else if (!strcmp(argv[i], "--threshold") && has_value) {
+            threshold_percent = strtod(argv[++i], nullptr);
+        } else if (!strcmp(argv[i], "--perf-counters")) {
+            options.perf_counters = true;
+        } else if (!strcmp(argv[i], "--scaling") && has_value) {
+            scaling_threads = strtoull(argv[++i], nullptr, 10);
+        } else if (!strcmp(argv[i], "--duration") && has_value) {
+            duration_ms = strtoull(argv[++i], nullptr, 10);
+        } else {
+            PrintUsage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (scaling_threads > 0) {
+        const vector<ScalingResult> results = RunScalingBenchmarks(scaling_threads, duration_ms, cout);
+        if (!json_path.empty()) {
+            ofstream file(json_path);
+            if (!file) {
+                cerr << "Opening the result file failed: " << json_path << endl;
+                return 2;
+            }
+            WriteScalingJSON(results, file);
+        }
+        return 0;
+    }
+
+    Harness harness;
+    RegisterCompilerBenchmarks(harness);
+    RegisterJITBenchmarks(harness);
+    const vector<Result> results = harness.Run(options, cout);
+
+    if (!json_path.empty()) {
+        ofstream file(json_path);
+        if (!file) {
+            cerr << "Opening the result file failed: " << json_path << endl;
+            return 2;
+        }
+        Harness::WriteJSON(results, file);
+    }
+    if (!baseline_path.empty()) {
+        ifstream file(baseline_path);
+        vector<Result> baseline;
+        if (!file || !Harness::ReadJSON(file, baseline)) {
+            cerr << "Reading the baseline failed: " << baseline_path << endl;
+            return 2;
+        }
+        cout << endl << "Compared to " << baseline_path << ":" << endl;
+        const size_t regressions = Harness::Compare(results, baseline, threshold_percent, cout);
+        if (regressions) {
+            cout << regressions << " regression(s) above " << threshold_percent << " %" << endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+//---------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+//---------------------------------------------------------------------------
+#include "Benchmark.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "lexer/Lexer.hpp"
+#include "optimization/ConstantPropagation.hpp"
+#include "optimization/DeadCodeElimination.hpp"
+#include "optimization/DeadStoreElimination.hpp"
+#include "parser/Parser.hpp"
+#include <memory>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+/// The sizes of the benchmarked functions in statements.
+static const std::vector<size_t> function_sizes = {10, 1000};
+//---------------------------------------------------------------------------
+/// Analyze a function.
+static std::unique_ptr<FunctionAST> Analyze(const SourceCodeManagement& scm, SemanticAnalyzer& semantic_analyzer) {
+    Parser parser(scm);
+    return semantic_analyzer.AnalyzeParseTree(parser.ParseFunctionDefinition());
+}
+//---------------------------------------------------------------------------
+/// Register a benchmark of an optimization pass.
+template <typename MakePass>
+static void AddPassBenchmark(Harness& harness, const std::string& name, const std::string& code, MakePass make_pass) {
+    harness.Add(name, [code, make_pass](State& state) {
+        state.SetBytesPerIteration(code.size());
+        SourceCodeManagement scm(code);
+        while (state.KeepRunning()) {
+            // The passes change the AST, so every iteration optimizes a new one.
+            state.PauseTiming();
+            SemanticAnalyzer semantic_analyzer;
+            std::unique_ptr<FunctionAST> ast = Analyze(scm, semantic_analyzer);
+            std::unique_ptr<OptimizationPass> pass = make_pass(semantic_analyzer.GetSymbolTable());
+            state.ResumeTiming();
+            pass->Optimize(*ast);
+            DoNotOptimize(ast);
+        }
+    });
+}
+//---------------------------------------------------------------------------
+void RegisterCompilerBenchmarks(Harness& harness) {
+    for (size_t size : function_sizes) {
+        const std::string code = GenerateFunction(size);
+        const std::string suffix = "/" + std::to_string(size);
+
+        harness.Add("lexer" + suffix, [code](State& state) {
+            state.SetBytesPerIteration(code.size());
+            SourceCodeManagement scm(code);
+            while (state.KeepRunning()) {
+                Lexer lexer(scm);
+                while (true) {
+                    const Token token = lexer.ProduceNextToken();
+                    if (token.GetType() == Token::Type::EOT || token.GetType() == Token::Type::ERROR) {
+                        break;
+                    }
+                }
+            }
+        });
+        harness.Add("parser" + suffix, [code](State& state) {
+            state.SetBytesPerIteration(code.size());
+            SourceCodeManagement scm(code);
+            while (state.KeepRunning()) {
+                Parser parser(scm);
+                auto parse_tree = parser.ParseFunctionDefinition();
+                DoNotOptimize(parse_tree);
+            }
+        });
+        harness.Add("semantic-analysis" + suffix, [code](State& state) {
+            state.SetBytesPerIteration(code.size());
+            SourceCodeManagement scm(code);
+            while (state.KeepRunning()) {
+                state.PauseTiming();
+                Parser parser(scm);
+                auto parse_tree = parser.ParseFunctionDefinition();
+                state.ResumeTiming();
+                SemanticAnalyzer semantic_analyzer;
+                auto ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+                DoNotOptimize(ast);
+            }
+        });
+        AddPassBenchmark(harness, "dead-code-elimination" + suffix, code, [](const SymbolTable&) { return std::make_unique<OptimizeDeadCode>(); });
+        AddPassBenchmark(harness, "constant-propagation" + suffix, code, [](const SymbolTable& symbol_table) { return std::make_unique<ConstantPropagation>(symbol_table); });
+        AddPassBenchmark(harness, "dead-store-elimination" + suffix, code, [](const SymbolTable&) { return std::make_unique<DeadStoreElimination>(); });
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
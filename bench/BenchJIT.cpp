@@ -0,0 +1,73 @@
+//---------------------------------------------------------------------------
+#include "Benchmark.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "jit/JIT.hpp"
+#include "optimization/PassManager.hpp"
+#include "parser/Parser.hpp"
+#include <memory>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+void RegisterJITBenchmarks(Harness& harness) {
+    for (size_t size : {10, 1000}) {
+        const std::string code = GenerateFunction(size);
+        const std::string suffix = "/" + std::to_string(size);
+
+        for (auto level : {OptimizationLevel::O0, OptimizationLevel::O3}) {
+            const std::string pipeline(PassManager::GetPipelineName(level));
+            harness.Add("evaluate/" + pipeline + suffix, [code, pipeline](State& state) {
+                SourceCodeManagement scm(code);
+                Parser parser(scm);
+                SemanticAnalyzer semantic_analyzer;
+                auto ast = semantic_analyzer.AnalyzeParseTree(parser.ParseFunctionDefinition());
+                PassManager().Run(pipeline, *ast, semantic_analyzer.GetSymbolTable());
+                EvaluationContext initial(semantic_analyzer.GetSymbolTable());
+                int64_t arguments[] = {1, 2, 3};
+                const auto& parameters = semantic_analyzer.GetParameters();
+                while (state.KeepRunning()) {
+                    // Copying the context is part of every evaluation, like in `FunctionHandle`.
+                    EvaluationContext ec = initial;
+                    for (size_t p = 0; p < parameters.size(); p++) {
+                        ec.GetValueTable().find(parameters[p])->second.SetValue(arguments[p]);
+                    }
+                    DoNotOptimize(ast->Evaluate(ec));
+                    arguments[0] = (arguments[0] + 1) & 0xFF;
+                }
+            });
+            harness.Add("call/" + pipeline + suffix, [code, level](State& state) {
+                JIT jit;
+                auto function = jit.RegisterFunction(code, level);
+                function(1, 2, 3);
+                int64_t a = 0;
+                while (state.KeepRunning()) {
+                    DoNotOptimize(function(a, 2, 3));
+                    a = (a + 1) & 0xFF;
+                }
+            });
+        }
+        harness.Add("compile" + suffix, [code](State& state) {
+            state.SetBytesPerIteration(code.size());
+            std::unique_ptr<JIT> jit;
+            while (state.KeepRunning()) {
+                // A new JIT for every iteration, so the registry does not grow.
+                state.PauseTiming();
+                jit = std::make_unique<JIT>();
+                state.ResumeTiming();
+                // The first call compiles the function.
+                auto function = jit->RegisterFunction(code);
+                DoNotOptimize(function(1, 2, 3));
+            }
+        });
+    }
+    harness.Add("call/constant", [](State& state) {
+        JIT jit;
+        auto function = jit.RegisterFunction("PARAM a; BEGIN RETURN 42 END.");
+        int64_t a = 0;
+        while (state.KeepRunning()) {
+            DoNotOptimize(function(a++));
+        }
+    });
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------
+#include "Benchmark.hpp"
+#include "jit/JIT.hpp"
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <memory>
+#include <thread>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The number of functions of the many functions scenario.
+constexpr size_t number_of_functions = 1000;
+/// The number of calls between two registrations of the mixed scenario.
+constexpr uint64_t calls_per_registration = 100;
+//---------------------------------------------------------------------------
+/// A scenario of concurrent calls.
+enum class Scenario {
+    /// All threads call the same function.
+    HotFunction,
+    /// The threads call random functions of many.
+    ManyFunctions,
+    /// The threads call random functions of many, while registering and compiling new ones.
+    RegisterWhileCalling,
+};
+//---------------------------------------------------------------------------
+const char* GetScenarioName(Scenario scenario) {
+    switch (scenario) {
+        case Scenario::HotFunction: return "hot-function";
+        case Scenario::ManyFunctions: return "many-functions";
+        case Scenario::RegisterWhileCalling: return "register-while-calling";
+    }
+    __builtin_unreachable();
+}
+//---------------------------------------------------------------------------
+/// Get the percentile of sorted samples.
+uint64_t GetPercentile(const std::vector<uint64_t>& samples, double percentile) {
+    if (samples.empty()) {
+        return 0;
+    }
+    const auto index = static_cast<size_t>(percentile * static_cast<double>(samples.size()));
+    return samples[std::min(index, samples.size() - 1)];
+}
+//---------------------------------------------------------------------------
+/// Run a scenario with a number of threads.
+ScalingResult RunScenario(Scenario scenario, size_t number_of_threads, uint64_t duration_ms) {
+    const std::string code = GenerateFunction(10);
+    JIT jit;
+    std::vector<FunctionHandle> functions;
+    for (size_t i = 0; i < (scenario == Scenario::HotFunction ? 1 : number_of_functions); i++) {
+        functions.push_back(jit.RegisterFunction(code));
+        functions.back()(1, 2, 3);
+    }
+    const JIT::LockStatistics before = jit.GetLockStatistics();
+
+    std::atomic<bool> start = false;
+    std::atomic<bool> stop = false;
+    std::vector<std::vector<uint64_t>> latencies(number_of_threads);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < number_of_threads; t++) {
+        threads.emplace_back([&, t]() {
+            std::vector<uint64_t>& samples = latencies[t];
+            samples.reserve(size_t(1) << 20);
+            uint64_t random = t + 1;
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (uint64_t call = 0; !stop.load(std::memory_order_relaxed); call++) {
+                // xorshift, to pick the functions without a shared state.
+                random ^= random << 13;
+                random ^= random >> 7;
+                random ^= random << 17;
+                if (scenario == Scenario::RegisterWhileCalling && call % calls_per_registration == 0) {
+                    // The first call compiles the new function.
+                    auto function = jit.RegisterFunction(code);
+                    DoNotOptimize(function(1, 2, 3));
+                }
+                FunctionHandle& function = functions[random % functions.size()];
+                const auto begin = std::chrono::steady_clock::now();
+                DoNotOptimize(function(static_cast<int64_t>(random & 0xFF), 2, 3));
+                samples.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()));
+            }
+        });
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    start.store(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(duration_ms));
+    stop.store(true);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    const JIT::LockStatistics after = jit.GetLockStatistics();
+
+    std::vector<uint64_t> samples;
+    for (auto& thread_samples : latencies) {
+        samples.insert(samples.end(), thread_samples.begin(), thread_samples.end());
+    }
+    std::sort(samples.begin(), samples.end());
+    ScalingResult result;
+    result.scenario = GetScenarioName(scenario);
+    result.threads = number_of_threads;
+    result.calls = samples.size();
+    result.calls_per_second = static_cast<double>(samples.size()) / seconds;
+    result.p50_ns = GetPercentile(samples, 0.5);
+    result.p99_ns = GetPercentile(samples, 0.99);
+    result.p999_ns = GetPercentile(samples, 0.999);
+    result.register_mutex_wait_ns = after.register_mutex.wait_ns - before.register_mutex.wait_ns;
+    result.register_mutex_contentions = after.register_mutex.contentions - before.register_mutex.contentions;
+    result.function_mutexes_wait_ns = after.function_mutexes.wait_ns - before.function_mutexes.wait_ns;
+    result.function_mutexes_contentions = after.function_mutexes.contentions - before.function_mutexes.contentions;
+    return result;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+std::vector<ScalingResult> RunScalingBenchmarks(size_t max_threads, uint64_t duration_ms, std::ostream& out) {
+    std::vector<ScalingResult> results;
+    out << std::left << std::setw(24) << "scenario" << std::right << std::setw(8) << "threads" << std::setw(14) << "calls/s"
+        << std::setw(10) << "p50 ns" << std::setw(10) << "p99 ns" << std::setw(10) << "p999 ns"
+        << std::setw(16) << "register wait" << std::setw(16) << "function wait" << std::endl;
+    for (auto scenario : {Scenario::HotFunction, Scenario::ManyFunctions, Scenario::RegisterWhileCalling}) {
+        // 1, 2, 4, ... threads and the maximum.
+        for (size_t threads = 1; threads <= max_threads; threads = threads * 2 > max_threads && threads != max_threads ? max_threads : threads * 2) {
+            ScalingResult result = RunScenario(scenario, threads, duration_ms);
+            out << std::left << std::setw(24) << result.scenario << std::right << std::setw(8) << result.threads
+                << std::setw(14) << std::fixed << std::setprecision(0) << result.calls_per_second
+                << std::setw(10) << result.p50_ns << std::setw(10) << result.p99_ns << std::setw(10) << result.p999_ns
+                << std::setw(13) << result.register_mutex_wait_ns / 1000 << " us" << std::setw(13) << result.function_mutexes_wait_ns / 1000 << " us" << std::endl;
+            results.push_back(std::move(result));
+        }
+    }
+    return results;
+}
+//---------------------------------------------------------------------------
+void WriteScalingJSON(const std::vector<ScalingResult>& results, std::ostream& out) {
+    out << "{\"scaling\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const ScalingResult& result = results[i];
+        out << (i ? ",\n" : "\n") << "{\"scenario\":\"" << result.scenario << "\",\"threads\":" << result.threads << ",\"calls\":" << result.calls
+            << std::fixed << std::setprecision(1) << ",\"calls_per_second\":" << result.calls_per_second
+            << ",\"p50_ns\":" << result.p50_ns << ",\"p99_ns\":" << result.p99_ns << ",\"p999_ns\":" << result.p999_ns
+            << ",\"register_mutex_wait_ns\":" << result.register_mutex_wait_ns << ",\"register_mutex_contentions\":" << result.register_mutex_contentions
+            << ",\"function_mutexes_wait_ns\":" << result.function_mutexes_wait_ns << ",\"function_mutexes_contentions\":" << result.function_mutexes_contentions << "}";
+    }
+    out << "\n]}\n";
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
@@ -0,0 +1,214 @@
+//---------------------------------------------------------------------------
+#include "Benchmark.hpp"
+#include "util/WorkloadGenerator.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <istream>
+#include <memory>
+#include <sstream>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+State::State(uint64_t iterations, PerfCounters* perf_counters) : iterations(iterations), remaining(iterations), perf_counters(perf_counters) {}
+//---------------------------------------------------------------------------
+void State::PauseTiming() {
+    if (running) {
+        if (perf_counters) { perf_counters->Stop(); }
+        elapsed_ns += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+        running = false;
+    }
+}
+//---------------------------------------------------------------------------
+void State::ResumeTiming() {
+    if (!running) {
+        begin = std::chrono::steady_clock::now();
+        running = true;
+        if (perf_counters) { perf_counters->Start(); }
+    }
+}
+//---------------------------------------------------------------------------
+uint64_t State::GetElapsedNanoseconds() const {
+    if (!running) {
+        return elapsed_ns;
+    }
+    return elapsed_ns + static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+//---------------------------------------------------------------------------
+void Harness::Add(std::string name, Function function) {
+    benchmarks.emplace_back(std::move(name), std::move(function));
+}
+//---------------------------------------------------------------------------
+/// Run a benchmark once.
+/// @return The measured nanoseconds.
+static uint64_t RunOnce(const Harness::Function& function, uint64_t iterations, PerfCounters* perf_counters = nullptr, uint64_t* bytes_per_iteration = nullptr) {
+    State state(iterations, perf_counters);
+    function(state);
+    if (bytes_per_iteration) { *bytes_per_iteration = state.GetBytesPerIteration(); }
+    return std::max<uint64_t>(state.GetElapsedNanoseconds(), 1);
+}
+//---------------------------------------------------------------------------
+/// Print the performance counters of a result per iteration and per source byte.
+static void PrintPerfCounters(const Result& result, std::ostream& out) {
+    out << "    per iteration:";
+    for (size_t i = 0; i < PerfCounters::number_of_events; i++) {
+        out << ' ' << PerfCounters::GetName(static_cast<PerfCounters::Event>(i)) << ' ' << std::fixed << std::setprecision(1) << result.perf_counters_per_iteration[i];
+    }
+    const double cycles = result.perf_counters_per_iteration[PerfCounters::Cycles];
+    if (cycles > 0) {
+        out << " ipc " << std::setprecision(2) << result.perf_counters_per_iteration[PerfCounters::Instructions] / cycles;
+    }
+    out << std::endl;
+    if (result.bytes_per_iteration) {
+        const auto bytes = static_cast<double>(result.bytes_per_iteration);
+        out << "    per source byte: cycles " << std::setprecision(2) << cycles / bytes << " instructions " << result.perf_counters_per_iteration[PerfCounters::Instructions] / bytes << std::endl;
+    }
+}
+//---------------------------------------------------------------------------
+std::vector<Result> Harness::Run(const Options& options, std::ostream& out) const {
+    std::vector<Result> results;
+    const uint64_t min_time_ns = options.min_time_ms * 1000000;
+    std::unique_ptr<PerfCounters> perf_counters;
+    if (options.perf_counters) {
+        perf_counters = std::make_unique<PerfCounters>();
+        if (!perf_counters->IsAnyAvailable()) {
+            out << "Hardware performance counters are unavailable (perf_event_open failed), measuring time only." << std::endl;
+            perf_counters.reset();
+        }
+    }
+    for (auto& [name, function] : benchmarks) {
+        if (name.find(options.filter) == std::string::npos) {
+            continue;
+        }
+        // Grow the iterations until a run takes long enough to be measured reliably.
+        uint64_t iterations = 1;
+        uint64_t ns = RunOnce(function, iterations);
+        while (ns < min_time_ns / 10 && iterations < (uint64_t(1) << 40)) {
+            iterations *= 10;
+            ns = RunOnce(function, iterations);
+        }
+        iterations = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(iterations) * static_cast<double>(min_time_ns) / static_cast<double>(ns)));
+
+        std::vector<double> ns_per_iteration;
+        if (perf_counters) { perf_counters->Reset(); }
+        uint64_t bytes_per_iteration = 0;
+        for (uint64_t r = 0; r < std::max<uint64_t>(options.repetitions, 1); r++) {
+            ns_per_iteration.push_back(static_cast<double>(RunOnce(function, iterations, perf_counters.get(), &bytes_per_iteration)) / static_cast<double>(iterations));
+        }
+        std::sort(ns_per_iteration.begin(), ns_per_iteration.end());
+        Result result;
+        result.bytes_per_iteration = bytes_per_iteration;
+        if (perf_counters) {
+            result.has_perf_counters = true;
+            result.perf_counters_per_iteration = perf_counters->Read();
+            for (auto& value : result.perf_counters_per_iteration) {
+                value /= static_cast<double>(iterations * ns_per_iteration.size());
+            }
+        }
+        result.name = name;
+        result.iterations = iterations;
+        result.repetitions = ns_per_iteration.size();
+        result.ns_per_iteration = ns_per_iteration[ns_per_iteration.size() / 2];
+        result.min_ns_per_iteration = ns_per_iteration.front();
+        out << std::left << std::setw(48) << name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.ns_per_iteration << " ns" << std::setw(14) << iterations << " iterations" << std::endl;
+        if (result.has_perf_counters) {
+            PrintPerfCounters(result, out);
+        }
+        results.push_back(std::move(result));
+    }
+    return results;
+}
+//---------------------------------------------------------------------------
+void Harness::WriteJSON(const std::vector<Result>& results, std::ostream& out) {
+    out << "{\"benchmarks\":[";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& result = results[i];
+        // The names are chosen by the benchmarks and contain no characters to escape.
+        out << (i ? ",\n" : "\n") << "{\"name\":\"" << result.name << "\",\"iterations\":" << result.iterations << ",\"repetitions\":" << result.repetitions
+            << std::fixed << std::setprecision(3) << ",\"ns_per_iteration\":" << result.ns_per_iteration << ",\"min_ns_per_iteration\":" << result.min_ns_per_iteration;
+        if (result.bytes_per_iteration) {
+            out << ",\"bytes_per_iteration\":" << result.bytes_per_iteration;
+        }
+        if (result.has_perf_counters) {
+            for (size_t e = 0; e < PerfCounters::number_of_events; e++) {
+                out << ",\"" << PerfCounters::GetName(static_cast<PerfCounters::Event>(e)) << "_per_iteration\":" << result.perf_counters_per_iteration[e];
+            }
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+}
+//---------------------------------------------------------------------------
+/// Find the value of a field in a JSON object written by `WriteJSON`.
+static bool FindField(const std::string& object, const std::string& field, std::string& value) {
+    const std::string key = "\"" + field + "\":";
+    const size_t begin = object.find(key);
+    if (begin == std::string::npos) {
+        return false;
+    }
+    size_t position = begin + key.size();
+    if (object[position] == '"') {
+        const size_t end = object.find('"', position + 1);
+        value = object.substr(position + 1, end - position - 1);
+    } else {
+        const size_t end = object.find_first_of(",}", position);
+        value = object.substr(position, end - position);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+bool Harness::ReadJSON(std::istream& in, std::vector<Result>& results) {
+    std::stringstream stream;
+    stream << in.rdbuf();
+    const std::string json = stream.str();
+    size_t position = json.find('[');
+    if (position == std::string::npos) {
+        return false;
+    }
+    while ((position = json.find('{', position + 1)) != std::string::npos) {
+        const size_t end = json.find('}', position);
+        if (end == std::string::npos) {
+            return false;
+        }
+        const std::string object = json.substr(position, end - position + 1);
+        Result result;
+        std::string ns_per_iteration;
+        if (!FindField(object, "name", result.name) || !FindField(object, "ns_per_iteration", ns_per_iteration)) {
+            return false;
+        }
+        result.ns_per_iteration = std::strtod(ns_per_iteration.c_str(), nullptr);
+        results.push_back(std::move(result));
+        position = end;
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+size_t Harness::Compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double threshold_percent, std::ostream& out) {
+    size_t regressions = 0;
+    for (auto& result : results) {
+        auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == result.name; });
+        if (it == baseline.end() || it->ns_per_iteration <= 0) {
+            continue;
+        }
+        const double change_percent = (result.ns_per_iteration / it->ns_per_iteration - 1) * 100;
+        const bool regression = change_percent > threshold_percent;
+        regressions += regression;
+        out << std::left << std::setw(48) << result.name << std::right << std::setw(10) << std::showpos << std::fixed << std::setprecision(1) << change_percent << std::noshowpos << " %"
+            << (regression ? "  REGRESSION" : "") << std::endl;
+    }
+    return regressions;
+}
+//---------------------------------------------------------------------------
+std::string GenerateFunction(size_t number_of_statements) {
+    WorkloadGenerator::Options options;
+    options.number_of_parameters = 3;
+    options.number_of_variables = 8;
+    options.number_of_constants = 4;
+    options.number_of_statements = number_of_statements;
+    // The calls measure the evaluation, not the error path.
+    options.nonzero_divisors = true;
+    WorkloadGenerator generator(number_of_statements, options);
+    return generator.Generate();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
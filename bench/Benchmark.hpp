@@ -0,0 +1,158 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "PerfCounters.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+/// Prevent the compiler from optimizing a value away.
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+//---------------------------------------------------------------------------
+/// The state of a benchmark run: the number of iterations and the measured time.
+/// The setup before the first `KeepRunning()` is not measured.
+class State {
+    public:
+    /// Constructor. With performance counters, they count while the timer runs.
+    explicit State(uint64_t iterations, PerfCounters* perf_counters = nullptr);
+    /// Start the timer at the first iteration and stop it after the last one.
+    /// @return True if another iteration has to be run.
+    bool KeepRunning() {
+        if (remaining == iterations) {
+            ResumeTiming();
+        }
+        if (remaining == 0) {
+            PauseTiming();
+            return false;
+        }
+        remaining--;
+        return true;
+    }
+    /// Get the number of iterations to run.
+    [[nodiscard]] uint64_t GetIterations() const { return iterations; }
+    /// Pause the timer, e.g. for the setup of an iteration.
+    void PauseTiming();
+    /// Resume the timer.
+    void ResumeTiming();
+    /// Get the measured nanoseconds.
+    [[nodiscard]] uint64_t GetElapsedNanoseconds() const;
+    /// Set the number of source bytes processed per iteration, to normalize the counters per byte.
+    void SetBytesPerIteration(uint64_t bytes) { bytes_per_iteration = bytes; }
+    /// Get the number of source bytes processed per iteration, 0 if not set.
+    [[nodiscard]] uint64_t GetBytesPerIteration() const { return bytes_per_iteration; }
+
+    private:
+    /// The number of iterations.
+    const uint64_t iterations;
+    /// The number of iterations not started yet.
+    uint64_t remaining;
+    /// The nanoseconds measured before the last pause.
+    uint64_t elapsed_ns = 0;
+    /// The begin of the running measurement.
+    std::chrono::steady_clock::time_point begin;
+    /// If the timer is running.
+    bool running = false;
+    /// The performance counters, nullptr if not collected.
+    PerfCounters* perf_counters;
+    /// The number of source bytes processed per iteration.
+    uint64_t bytes_per_iteration = 0;
+};
+//---------------------------------------------------------------------------
+/// The result of a benchmark.
+struct Result {
+    /// The name.
+    std::string name;
+    /// The iterations per repetition.
+    uint64_t iterations = 0;
+    /// The number of repetitions.
+    uint64_t repetitions = 0;
+    /// The median nanoseconds per iteration of the repetitions.
+    double ns_per_iteration = 0;
+    /// The minimum nanoseconds per iteration of the repetitions.
+    double min_ns_per_iteration = 0;
+    /// The number of source bytes processed per iteration, 0 if the benchmark does not process source code.
+    uint64_t bytes_per_iteration = 0;
+    /// If the hardware performance counters were collected.
+    bool has_perf_counters = false;
+    /// The hardware performance counters per iteration over all repetitions.
+    PerfCounters::Values perf_counters_per_iteration = {};
+};
+//---------------------------------------------------------------------------
+/// Runs the registered benchmarks and compares them against a baseline.
+class Harness {
+    public:
+    /// A benchmark, which runs iterations while `State::KeepRunning()`.
+    using Function = std::function<void(State&)>;
+    /// The options of a run.
+    struct Options {
+        /// Only run the benchmarks whose name contains this string.
+        std::string filter;
+        /// The minimum time of a repetition in milliseconds.
+        uint64_t min_time_ms = 100;
+        /// The number of repetitions.
+        uint64_t repetitions = 5;
+        /// Collect the hardware performance counters.
+        bool perf_counters = false;
+    };
+
+    /// Register a benchmark.
+    void Add(std::string name, Function function);
+    /// Run the benchmarks matching the filter, printing a line per benchmark.
+    std::vector<Result> Run(const Options& options, std::ostream& out) const;
+
+    /// Write the results as JSON.
+    static void WriteJSON(const std::vector<Result>& results, std::ostream& out);
+    /// Read the results written by `WriteJSON`.
+    /// @return True for success, false for failure.
+    static bool ReadJSON(std::istream& in, std::vector<Result>& results);
+    /// Compare the results against a baseline, printing the change of every benchmark in both.
+    /// @return The number of benchmarks slower than the baseline by more than `threshold_percent`.
+    static size_t Compare(const std::vector<Result>& results, const std::vector<Result>& baseline, double threshold_percent, std::ostream& out);
+
+    private:
+    /// The registered benchmarks.
+    std::vector<std::pair<std::string, Function>> benchmarks;
+};
+//---------------------------------------------------------------------------
+/// The result of a multithreaded call benchmark.
+struct ScalingResult {
+    /// The name of the scenario.
+    std::string scenario;
+    /// The number of calling threads.
+    size_t threads = 0;
+    /// The number of calls.
+    uint64_t calls = 0;
+    /// The throughput.
+    double calls_per_second = 0;
+    /// The percentiles of the call latency in nanoseconds.
+    uint64_t p50_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    /// The time waited for the register mutex in nanoseconds and the number of waits.
+    uint64_t register_mutex_wait_ns = 0;
+    uint64_t register_mutex_contentions = 0;
+    /// The time waited for the functions' mutexes in nanoseconds and the number of waits.
+    uint64_t function_mutexes_wait_ns = 0;
+    uint64_t function_mutexes_contentions = 0;
+};
+//---------------------------------------------------------------------------
+/// Run the multithreaded call scenarios with 1, 2, 4, ... up to `max_threads` threads for `duration_ms` each.
+std::vector<ScalingResult> RunScalingBenchmarks(size_t max_threads, uint64_t duration_ms, std::ostream& out);
+/// Write the results of the multithreaded call benchmarks as JSON.
+void WriteScalingJSON(const std::vector<ScalingResult>& results, std::ostream& out);
+/// Register the benchmarks of the lexer, the parser, the semantic analysis and the optimization passes.
+void RegisterCompilerBenchmarks(Harness& harness);
+/// Register the benchmarks of the evaluation and the function calls.
+void RegisterJITBenchmarks(Harness& harness);
+/// Generate a function with three parameters and `number_of_statements` statements, which never divides by zero.
+std::string GenerateFunction(size_t number_of_statements);
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
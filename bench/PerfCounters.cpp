@@ -0,0 +1,114 @@
+//---------------------------------------------------------------------------
+#include "PerfCounters.hpp"
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Get the configuration of a hardware cache event's read misses.
+constexpr uint64_t CacheReadMisses(uint64_t cache) {
+    return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+//---------------------------------------------------------------------------
+/// The type and configuration of the events.
+constexpr std::array<std::pair<uint32_t, uint64_t>, PerfCounters::number_of_events> event_configurations = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, CacheReadMisses(PERF_COUNT_HW_CACHE_L1D)},
+    {PERF_TYPE_HW_CACHE, CacheReadMisses(PERF_COUNT_HW_CACHE_LL)},
+    {PERF_TYPE_HW_CACHE, CacheReadMisses(PERF_COUNT_HW_CACHE_ITLB)},
+}};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < number_of_events; i++) {
+        perf_event_attr attributes;
+        std::memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = event_configurations[i].first;
+        attributes.config = event_configurations[i].second;
+        attributes.disabled = 1;
+        // Only user space, which is allowed without privileges.
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        descriptors[i] = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+}
+//---------------------------------------------------------------------------
+PerfCounters::~PerfCounters() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            close(descriptor);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+const char* PerfCounters::GetName(Event event) {
+    switch (event) {
+        case Cycles: return "cycles";
+        case Instructions: return "instructions";
+        case BranchMisses: return "branch_misses";
+        case L1DataMisses: return "l1d_misses";
+        case LastLevelCacheMisses: return "llc_misses";
+        case InstructionTLBMisses: return "itlb_misses";
+    }
+    __builtin_unreachable();
+}
+//---------------------------------------------------------------------------
+bool PerfCounters::IsAnyAvailable() const {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+//---------------------------------------------------------------------------
+void PerfCounters::Start() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void PerfCounters::Stop() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void PerfCounters::Reset() {
+    for (int descriptor : descriptors) {
+        if (descriptor >= 0) {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        }
+    }
+}
+//---------------------------------------------------------------------------
+PerfCounters::Values PerfCounters::Read() const {
+    Values values = {};
+    for (size_t i = 0; i < number_of_events; i++) {
+        // The value, the time enabled and the time running.
+        uint64_t data[3];
+        if (descriptors[i] < 0 || read(descriptors[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data))) {
+            continue;
+        }
+        // More events than hardware counters are multiplexed: extrapolate to the enabled time.
+        values[i] = data[2] ? static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]) : 0;
+    }
+    return values;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
@@ -0,0 +1,55 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <array>
+#include <cstdint>
+#include <string>
+//---------------------------------------------------------------------------
+namespace pljit::bench {
+//---------------------------------------------------------------------------
+/// Hardware performance counters of the calling thread, read with `perf_event_open`.
+/// Counters the kernel or the machine does not provide (e.g. in containers or VMs) are reported as unavailable.
+class PerfCounters {
+    public:
+    /// The counted events.
+    enum Event : size_t {
+        Cycles,
+        Instructions,
+        BranchMisses,
+        L1DataMisses,
+        LastLevelCacheMisses,
+        InstructionTLBMisses,
+    };
+    /// The number of events.
+    static constexpr size_t number_of_events = 6;
+    /// The counter values, scaled up when the kernel multiplexed the counters.
+    using Values = std::array<double, number_of_events>;
+
+    /// Constructor, opens the counters.
+    PerfCounters();
+    /// Destructor, closes the counters.
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// Get the name of an event.
+    static const char* GetName(Event event);
+    /// If the event could be opened.
+    [[nodiscard]] bool IsAvailable(Event event) const { return descriptors[event] >= 0; }
+    /// If any event could be opened.
+    [[nodiscard]] bool IsAnyAvailable() const;
+    /// Start counting.
+    void Start();
+    /// Stop counting.
+    void Stop();
+    /// Reset the counters to zero.
+    void Reset();
+    /// Read the counters. Unavailable ones are 0.
+    [[nodiscard]] Values Read() const;
+
+    private:
+    /// The file descriptors of the events, -1 if unavailable.
+    std::array<int, number_of_events> descriptors;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit::bench
+//---------------------------------------------------------------------------
@@ -1,11 +1,41 @@
 find_package(GTest)
 
+if (GTEST_FOUND)
+   # An installed Google Test may add the older C++ runtime of its installation, e.g. of a conda environment, to the run path
+   # of the tests, which then fail to start. Check that a test program runs, otherwise use the bundled one.
+   include(CheckCXXSourceRuns)
+   set(CMAKE_REQUIRED_LIBRARIES GTest::GTest Threads::Threads)
+   check_cxx_source_runs("
+      #include <condition_variable>
+      #include <mutex>
+      #include <gtest/gtest.h>
+      int main(int argc, char** argv) {
+         testing::InitGoogleTest(&argc, argv);
+         std::mutex mutex;
+         std::condition_variable condition;
+         std::unique_lock<std::mutex> lock(mutex);
+         condition.wait(lock, [] { return true; });
+         return 0;
+      }" HAVE_RUNNABLE_GTEST)
+   unset(CMAKE_REQUIRED_LIBRARIES)
+
+   if (HAVE_RUNNABLE_GTEST)
+      set(GTEST_TARGET GTest::GTest)
+   else ()
+      message(STATUS "The installed Google Test does not run with the C++ runtime of the compiler")
+      set(GTEST_FOUND OFF)
+   endif ()
+endif ()
+
 if (NOT GTEST_FOUND)
    message(STATUS "Adding bundled Google Test")
    set(BUILD_GMOCK OFF CACHE BOOL INTERNAL)
    set(INSTALL_GTEST OFF CACHE BOOL INTERNAL)
 
    add_subdirectory(${CMAKE_CURRENT_LIST_DIR}/thirdparty/googletest)
+   # The bundled version predates the warnings of newer compilers, which it turns into errors.
+   target_compile_options(gtest PRIVATE -Wno-error)
 
-   add_library(GTest::GTest ALIAS gtest)
+   # The imported target of an installed Google Test, which does not run, keeps its name.
+   set(GTEST_TARGET gtest)
 endif ()
@@ -1,6 +1,7 @@
 //---------------------------------------------------------------------------
 #include "ast/ASTNode.hpp"
 #include "ast/ASTNodeVisitor.hpp"
+#include "util/MemoryUsage.hpp"
 #include <cassert>
 //---------------------------------------------------------------------------
 namespace pljit {
@@ -19,6 +20,10 @@ int64_t FunctionAST::Evaluate(EvaluationContext& ec) const {
     for (auto& child: children) {
         child->Evaluate(ec);
 
+        // The remaining statements are not evaluated after a division by zero.
+        if (ec.GetDivisionByZero()) {
+            return 0;
+        }
         // Return until "RETURN" is evaluated.
         if (ec.IfReturnValue()) {
             return ec.GetReturnValue();
@@ -35,6 +40,90 @@ void FunctionAST::EliminateLastChild() {
     children.pop_back();
 }
 //---------------------------------------------------------------------------
+void FunctionAST::EliminateChild(size_t child_index) {
+    assert(child_index < children.size());
+    assert(children[child_index]->GetType() != ASTNode::Type::ReturnStatement);
+    children.erase(children.begin() + child_index);
+}
+//---------------------------------------------------------------------------
+void FunctionAST::PrependChild(std::unique_ptr<StatementAST> child) {
+    assert(child);
+    children.insert(children.begin(), std::move(child));
+}
+//---------------------------------------------------------------------------
+/// Check if an expression contains a division, which possibly fails.
+static bool ContainsDivision(const ASTNode& node) {
+    switch (node.GetType()) {
+        case ASTNode::Type::UnaryExpression:
+            return ContainsDivision(*static_cast<const UnaryExpressionAST&>(node).GetChild());
+        case ASTNode::Type::BinaryExpression:
+            {
+                const auto& binary = static_cast<const BinaryExpressionAST&>(node);
+                return binary.GetBinaryOperatorType() == BinaryExpressionAST::BinaryOperator::DIV ||
+                    ContainsDivision(*binary.GetLeftChild()) || ContainsDivision(*binary.GetRightChild());
+            }
+        default:
+            return false;
+    }
+}
+//---------------------------------------------------------------------------
+/// Get the number of bytes of a node and its children.
+static size_t GetNodeMemoryUsage(const ASTNode& node) {
+    switch (node.GetType()) {
+        case ASTNode::Type::Function:
+            {
+                const auto& function = static_cast<const FunctionAST&>(node);
+                size_t bytes = sizeof(FunctionAST) + memory_usage::Of(function.GetChildren());
+                for (auto& child : function.GetChildren()) {
+                    bytes += GetNodeMemoryUsage(*child);
+                }
+                return bytes;
+            }
+        case ASTNode::Type::LiteralPrimaryExpression:
+            return sizeof(LiteralPrimaryExpressionAST);
+        case ASTNode::Type::IdentifierPrimaryExpression:
+            return sizeof(IdentifierPrimaryExpressionAST);
+        case ASTNode::Type::UnaryExpression:
+            return sizeof(UnaryExpressionAST) + GetNodeMemoryUsage(*static_cast<const UnaryExpressionAST&>(node).GetChild());
+        case ASTNode::Type::BinaryExpression:
+            {
+                const auto& binary = static_cast<const BinaryExpressionAST&>(node);
+                return sizeof(BinaryExpressionAST) + GetNodeMemoryUsage(*binary.GetLeftChild()) + GetNodeMemoryUsage(*binary.GetRightChild());
+            }
+        case ASTNode::Type::AssignmentStatement:
+            {
+                const auto& assignment = static_cast<const AssignmentStatementAST&>(node);
+                return sizeof(AssignmentStatementAST) + GetNodeMemoryUsage(*assignment.GetIdentifier()) + GetNodeMemoryUsage(*assignment.GetExpression());
+            }
+        case ASTNode::Type::ReturnStatement:
+            return sizeof(ReturnStatementAST) + GetNodeMemoryUsage(*static_cast<const ReturnStatementAST&>(node).GetExpression());
+    }
+    __builtin_unreachable();
+}
+//---------------------------------------------------------------------------
+size_t FunctionAST::GetMemoryUsage() const {
+    return GetNodeMemoryUsage(*this);
+}
+//---------------------------------------------------------------------------
+std::optional<int64_t> FunctionAST::GetConstantReturnValue() const {
+    for (auto& child: children) {
+        if (child->GetType() == ASTNode::Type::ReturnStatement) {
+            // Only the first "RETURN" is evaluated.
+            const auto& expression = static_cast<const ReturnStatementAST&>(*child).GetExpression();
+            if (expression->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                return std::nullopt;
+            }
+            return static_cast<const LiteralPrimaryExpressionAST&>(*expression).GetValue();
+        }
+        // The statements in front of the "RETURN" are skipped, so they must not fail.
+        assert(child->GetType() == ASTNode::Type::AssignmentStatement);
+        if (ContainsDivision(*static_cast<const AssignmentStatementAST&>(*child).GetExpression())) {
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+//---------------------------------------------------------------------------
 void FunctionAST::Accept(ASTNodeVisitor& v) { v.Visit(*this); }
 //---------------------------------------------------------------------------
 LiteralPrimaryExpressionAST::LiteralPrimaryExpressionAST(int64_t value) : ExpressionAST(ASTNode::Type::LiteralPrimaryExpression), value(value) {}
@@ -75,6 +164,11 @@ int64_t UnaryExpressionAST::Evaluate(EvaluationContext& ec) const {
     __builtin_unreachable();
 }
 //---------------------------------------------------------------------------
+void UnaryExpressionAST::SetChildToConstantLiteral(int64_t value) {
+    assert(child->GetType() != ASTNode::Type::LiteralPrimaryExpression);
+    child = std::make_unique<LiteralPrimaryExpressionAST>(value);
+}
+//---------------------------------------------------------------------------
 BinaryExpressionAST::BinaryExpressionAST(BinaryOperator op, std::unique_ptr<ASTNode> left, std::unique_ptr<ASTNode> right) :  ExpressionAST(Type::BinaryExpression), op(op), left(std::move(left)), right(std::move(right)) {}
 //---------------------------------------------------------------------------
 BinaryExpressionAST::BinaryOperator BinaryExpressionAST::GetBinaryOperatorType() const { return op; }
@@ -96,7 +190,7 @@ int64_t BinaryExpressionAST::Evaluate(EvaluationContext& ec) const {
         case BinaryExpressionAST::BinaryOperator::DIV:
             const int64_t right_value = right->Evaluate(ec);
             if (right_value == 0) {
-                assert(!ec.GetDivisionByZero());
+                // An expression may contain several divisions by zero.
                 ec.SetDivisionByZero();
                 return 0;
             }
@@ -105,6 +199,16 @@ int64_t BinaryExpressionAST::Evaluate(EvaluationContext& ec) const {
     __builtin_unreachable();
 }
 //---------------------------------------------------------------------------
+void BinaryExpressionAST::SetLeftChildToConstantLiteral(int64_t value) {
+    assert(left->GetType() != ASTNode::Type::LiteralPrimaryExpression);
+    left = std::make_unique<LiteralPrimaryExpressionAST>(value);
+}
+//---------------------------------------------------------------------------
+void BinaryExpressionAST::SetRightChildToConstantLiteral(int64_t value) {
+    assert(right->GetType() != ASTNode::Type::LiteralPrimaryExpression);
+    right = std::make_unique<LiteralPrimaryExpressionAST>(value);
+}
+//---------------------------------------------------------------------------
 AssignmentStatementAST::AssignmentStatementAST(std::unique_ptr<IdentifierPrimaryExpressionAST> identifier, std::unique_ptr<ASTNode> expression) : StatementAST(Type::AssignmentStatement), identifier(std::move(identifier)), expression(std::move(expression)) {}
 //---------------------------------------------------------------------------
 const std::unique_ptr<IdentifierPrimaryExpressionAST>& AssignmentStatementAST::GetIdentifier() const { return identifier; }
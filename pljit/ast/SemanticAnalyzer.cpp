@@ -84,6 +84,8 @@ std::unique_ptr<FunctionAST> SemanticAnalyzer::AnalyzeParseTree(std::unique_ptr<
 //---------------------------------------------------------------------------
 const SymbolTable& SemanticAnalyzer::GetSymbolTable() const { return symbol_table; }
 //---------------------------------------------------------------------------
+const std::vector<std::string_view>& SemanticAnalyzer::GetParameters() const { return parameters; }
+//---------------------------------------------------------------------------
 bool SemanticAnalyzer::AnalyzeDeclarations(const NonTerminalParseTreeNode* const node, Symbol::Type type) {
     // parameter-declarations = "PARAM" declarator-list ";".
     // variable-declarations = "VAR" declarator-list ";".
@@ -105,6 +107,9 @@ bool SemanticAnalyzer::AnalyzeDeclarations(const NonTerminalParseTreeNode* const
             const auto* const identifer_node = static_cast<const IdentifierParseTreeNode*>(child.get());
             if (symbol_table.find(identifer_node->GetName()) == symbol_table.end()) {
                 symbol_table.emplace(identifer_node->GetName(), Symbol(type, (type != Symbol::Type::VARIABLE), child->GetSourceCodeReference()));
+                if (type == Symbol::Type::PARAMETER) {
+                    parameters.emplace_back(identifer_node->GetName());
+                }
             } else {
                 // Duplicate identifier name found!
                 identifer_node->GetSourceCodeReference().PrintContext("The same identifier being declared twice.");
@@ -203,14 +208,17 @@ std::unique_ptr<StatementAST> SemanticAnalyzer::AnalyzeStatement(NonTerminalPars
             it->second.SetInitialized();
         }
         assert(it->second.IfInitialized());
-        return std::make_unique<AssignmentStatementAST>(std::make_unique<IdentifierPrimaryExpressionAST>(identifer_node->GetName()),
-                                                        AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(assignment_expression->GetChildren().back().get())));
+        std::unique_ptr<ExpressionAST> expression = AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(assignment_expression->GetChildren().back().get()));
+        if (!expression) { return nullptr; }
+        return std::make_unique<AssignmentStatementAST>(std::make_unique<IdentifierPrimaryExpressionAST>(identifer_node->GetName()), std::move(expression));
     } else {
         // "RETURN" additive-expression.
         assert(statement->GetChildren().size() == 2);
         assert(statement->GetChildren()[0]->GetType() == ParseTreeNode::Type::GenericToken);  // "RETURN".
         assert(statement->GetChildren()[1]->GetType() == ParseTreeNode::Type::AdditiveExpression);  // additive-expression.
-        return std::make_unique<ReturnStatementAST>(AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(statement->GetChildren().back().get())));
+        std::unique_ptr<ExpressionAST> expression = AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(statement->GetChildren().back().get()));
+        if (!expression) { return nullptr; }
+        return std::make_unique<ReturnStatementAST>(std::move(expression));
     }
 }
 //---------------------------------------------------------------------------
@@ -225,10 +233,14 @@ std::unique_ptr<ExpressionAST> SemanticAnalyzer::AnalyzeAdditiveExpression(NonTe
         // with *additive-expression*.
         assert(node->GetChildren().size() == 3);
         assert(node->GetChildren()[1]->GetType() == ParseTreeNode::Type::GenericToken);
+        std::unique_ptr<ExpressionAST> left = AnalyzeMultiplicativeExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren().front().get()));
+        if (!left) { return nullptr; }
+        std::unique_ptr<ExpressionAST> right = AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren().back().get()));
+        if (!right) { return nullptr; }
         return std::make_unique<BinaryExpressionAST>
             (static_cast<OperatorAlternationParseTreeNode*>(node->GetChildren()[1].get())->GetOperatorType() == OperatorAlternationParseTreeNode::Plus ? BinaryExpressionAST::BinaryOperator::PLUS : BinaryExpressionAST::BinaryOperator::MINUS /* operand */,
-            AnalyzeMultiplicativeExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren().front().get())) /* left: multiplicative-expression */,
-            AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren().back().get()))) /* right: additive-expression */;
+            std::move(left) /* left: multiplicative-expression */,
+            std::move(right)) /* right: additive-expression */;
     }
 }
 //---------------------------------------------------------------------------
@@ -270,6 +282,7 @@ std::unique_ptr<ExpressionAST> SemanticAnalyzer::AnalyzeMultiplicativeExpression
         assert(primary_expression->GetChildren()[1]->GetType() == ParseTreeNode::Type::AdditiveExpression);
         assert(primary_expression->GetChildren()[2]->GetType() == ParseTreeNode::Type::GenericToken);
         result = AnalyzeAdditiveExpression(static_cast<NonTerminalParseTreeNode*>(primary_expression->GetChildren()[1].get()));
+        if (!result) { return nullptr; }
     }
     assert(result);
 
@@ -286,9 +299,11 @@ std::unique_ptr<ExpressionAST> SemanticAnalyzer::AnalyzeMultiplicativeExpression
     if (node->GetChildren().size() == 3) {
         assert(node->GetChildren()[1]->GetType() == ParseTreeNode::Type::GenericToken);
         assert(node->GetChildren()[2]->GetType() == ParseTreeNode::Type::MultiplicativeExpression);
+        std::unique_ptr<ExpressionAST> right = AnalyzeMultiplicativeExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren()[2].get()));
+        if (!right) { return nullptr; }
         result = std::make_unique<BinaryExpressionAST>(static_cast<OperatorAlternationParseTreeNode*>(node->GetChildren()[1].get())->GetOperatorType() == OperatorAlternationParseTreeNode::Multiply ? BinaryExpressionAST::MUL : BinaryExpressionAST::DIV,
             std::move(result),
-            AnalyzeMultiplicativeExpression(static_cast<NonTerminalParseTreeNode*>(node->GetChildren()[2].get())));
+            std::move(right));
     }
     return result;
 }
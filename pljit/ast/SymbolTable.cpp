@@ -24,6 +24,12 @@ void Symbol::SetUninitialized() {
     initialized = false;
 }
 //---------------------------------------------------------------------------
+void Symbol::SetToVariable() {
+    assert(type == Symbol::Type::PARAMETER);
+    type = Symbol::Type::VARIABLE;
+    initialized = true;
+}
+//---------------------------------------------------------------------------
 const std::string_view Symbol::GetName() const { return name; }
 //---------------------------------------------------------------------------
 int64_t Symbol::GetValue() const {
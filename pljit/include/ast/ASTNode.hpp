@@ -4,6 +4,7 @@
 #include <string>
 #include <string_view>
 #include <memory>
+#include <optional>
 #include <vector>
 //---------------------------------------------------------------------------
 namespace pljit {
@@ -67,6 +68,14 @@ class FunctionAST : public ASTNode {
     const std::vector<std::unique_ptr<StatementAST>>& GetChildren() const;
     /// Eliminate the last child.
     void EliminateLastChild();
+    /// Eliminate the child at the index, which must not be a "RETURN".
+    void EliminateChild(size_t child_index);
+    /// Insert a statement in front of all children.
+    void PrependChild(std::unique_ptr<StatementAST> child);
+    /// Get the return value, if the function always returns the same literal and cannot fail with a division by zero error.
+    [[nodiscard]] std::optional<int64_t> GetConstantReturnValue() const;
+    /// Get the number of bytes retained by the AST.
+    [[nodiscard]] size_t GetMemoryUsage() const;
     /// Accept function for the visitor.
     void Accept(ASTNodeVisitor& v) override;
     /// Evaluate the node.
@@ -136,12 +145,14 @@ class UnaryExpressionAST : public ExpressionAST {
     void Accept(ASTNodeVisitor& v) override;
     /// Evaluate the node.
     virtual int64_t Evaluate(EvaluationContext& ec) const override;
+    /// Optimize with constant replacement of the child.
+    void SetChildToConstantLiteral(int64_t value);
 
     private:
     /// The Unary Operator.
     const UnaryOperator op;
-    /// The child: primary-expression.
-    const std::unique_ptr<ASTNode> child;
+    /// The child: primary-expression: non-const, possible be replace in the optimization pass: constant propagation.
+    std::unique_ptr<ASTNode> child;
 };
 //---------------------------------------------------------------------------
 /// Grammar:
@@ -168,14 +179,18 @@ class BinaryExpressionAST : public ExpressionAST {
     void Accept(ASTNodeVisitor& v) override;
     /// Evaluate the node.
     virtual int64_t Evaluate(EvaluationContext& ec) const override;
+    /// Optimize with constant replacement of the left child.
+    void SetLeftChildToConstantLiteral(int64_t value);
+    /// Optimize with constant replacement of the right child.
+    void SetRightChildToConstantLiteral(int64_t value);
 
     private:
     /// The Binary Operator
     const BinaryOperator op;
-    /// The left child.
-    const std::unique_ptr<ASTNode> left;
-    /// The right child.
-    const std::unique_ptr<ASTNode> right;
+    /// The left child: non-const, possible be replace in the optimization pass: constant propagation.
+    std::unique_ptr<ASTNode> left;
+    /// The right child: non-const, possible be replace in the optimization pass: constant propagation.
+    std::unique_ptr<ASTNode> right;
 };
 //---------------------------------------------------------------------------
 /// Grammar:
@@ -7,6 +7,8 @@ namespace pljit {
 /// A visitor for the AST.
 class ASTNodeVisitor {
     public:
+    /// Destructor, the optimization passes are owned through base pointers.
+    virtual ~ASTNodeVisitor() = default;
     /// Visit methods for the IdentifierPrimaryExpressionAST.
     virtual void Visit(IdentifierPrimaryExpressionAST&) = 0;
     /// Visit methods for the LiteralPrimaryExpressionAST.
@@ -23,10 +23,14 @@ class SemanticAnalyzer {
 
     /// Get the symbol table.
     const SymbolTable& GetSymbolTable() const;
+    /// Get the parameters' names in declaration order.
+    const std::vector<std::string_view>& GetParameters() const;
 
     private:
     /// A symbol table keeps track of all identifiers.
     SymbolTable symbol_table;
+    /// The parameters' names in declaration order: the symbol table is unordered.
+    std::vector<std::string_view> parameters;
 
     /// The function for analyze a statement of a parse tree and the generation of an AST node.
     /// @return unique pointer to AssignmentStatementAST or ReturnStatementAST. nullptr_t if failure (using undeclared identifiers or assignment to constants).
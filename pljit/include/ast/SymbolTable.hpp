@@ -26,6 +26,8 @@ class Symbol {
     void SetInitialized();
     /// Set as uninitialized. Only for evaluation and constant propagation.
     void SetUninitialized();
+    /// Turn a parameter into an initialized variable. Only for specialization.
+    void SetToVariable();
     /// Get identifier (symbol) name.
     const std::string_view GetName() const;
     /// Get value.
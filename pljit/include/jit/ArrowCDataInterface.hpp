@@ -0,0 +1,66 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstdint>
+//---------------------------------------------------------------------------
+/// The structs of the Arrow C Data Interface (https://arrow.apache.org/docs/format/CDataInterface.html).
+/// They are the stable ABI of the specification, so they are defined here instead of depending on an Arrow library.
+/// The guard is the one of the specification, so the definitions do not clash with an included `arrow/c/abi.h`.
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+//---------------------------------------------------------------------------
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+//---------------------------------------------------------------------------
+extern "C" {
+//---------------------------------------------------------------------------
+/// The type of an array.
+struct ArrowSchema {
+    /// The type, e.g. "l" for int64 or "+s" for a struct.
+    const char* format;
+    /// The field name, may be nullptr.
+    const char* name;
+    /// The metadata, may be nullptr.
+    const char* metadata;
+    /// The `ARROW_FLAG_*` flags.
+    int64_t flags;
+    /// The number of children.
+    int64_t n_children;
+    /// The children's types.
+    struct ArrowSchema** children;
+    /// The dictionary's type, nullptr if not dictionary-encoded.
+    struct ArrowSchema* dictionary;
+    /// Releases the schema, nullptr if released.
+    void (*release)(struct ArrowSchema*);
+    /// The producer's data.
+    void* private_data;
+};
+//---------------------------------------------------------------------------
+/// The data of an array.
+struct ArrowArray {
+    /// The number of values.
+    int64_t length;
+    /// The number of nulls, -1 if not computed.
+    int64_t null_count;
+    /// The logical offset into the buffers.
+    int64_t offset;
+    /// The number of buffers.
+    int64_t n_buffers;
+    /// The number of children.
+    int64_t n_children;
+    /// The buffers. For int64: the validity bitmap (may be nullptr without nulls) and the values.
+    const void** buffers;
+    /// The children's data.
+    struct ArrowArray** children;
+    /// The dictionary's data, nullptr if not dictionary-encoded.
+    struct ArrowArray* dictionary;
+    /// Releases the array, nullptr if released.
+    void (*release)(struct ArrowArray*);
+    /// The producer's data.
+    void* private_data;
+};
+//---------------------------------------------------------------------------
+} // extern "C"
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
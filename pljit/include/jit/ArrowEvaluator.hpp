@@ -0,0 +1,37 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/ArrowCDataInterface.hpp"
+#include "jit/ColumnEvaluator.hpp"
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Evaluates a function over int64 columns of the Arrow C Data Interface, a column per parameter.
+/// The input values are read in place. A row is null in the result, if an argument is null or the evaluation fails with a division by zero.
+/// The result is exported as a nullable int64 array, which the consumer releases.
+class ArrowEvaluator {
+    public:
+    /// Constructor.
+    explicit ArrowEvaluator(FunctionHandle function);
+    /// Constructor.
+    ArrowEvaluator(FunctionHandle function, ColumnEvaluator::Options options);
+    /// Evaluate the function for the columns of the same length, which are not released.
+    /// @return True for success, false for failure (compilation error, a column not of type int64, or columns of different lengths).
+    bool Evaluate(const std::vector<const ArrowSchema*>& schemas, const std::vector<const ArrowArray*>& arrays, ArrowSchema* result_schema, ArrowArray* result);
+    /// Evaluate the function for the children of a struct array, e.g. an exported record batch, which is not released.
+    /// @return True for success, false for failure.
+    bool EvaluateRecordBatch(const ArrowSchema& schema, const ArrowArray& batch, ArrowSchema* result_schema, ArrowArray* result);
+    /// Get the counters of the last evaluation.
+    [[nodiscard]] const ColumnEvaluator::Statistics& GetStatistics() const;
+
+    private:
+    /// The evaluator of the values.
+    ColumnEvaluator evaluator;
+
+    /// Evaluate the columns, with the rows of `batch_validity` (a bitmap at `batch_offset`, may be nullptr) being null.
+    bool Evaluate(const std::vector<const ArrowSchema*>& schemas, const std::vector<const ArrowArray*>& arrays, int64_t length, const uint8_t* batch_validity, int64_t batch_offset,
+                  ArrowSchema* result_schema, ArrowArray* result);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
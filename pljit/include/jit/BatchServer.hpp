@@ -0,0 +1,65 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/JIT.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Evaluates registered functions for a stream of argument rows.
+/// All functions take the same arguments, every row gets one result per function.
+/// A reader thread parses the input in large chunks into batches, while the calling thread evaluates the previous batch and writes its results.
+class BatchServer {
+    public:
+    /// The format of the rows.
+    enum class Format {
+        /// Input: a line of integers separated by spaces, tabs or commas per row. Empty lines are skipped.
+        /// Output: a line per row with the results separated by spaces, "error" for a division by zero.
+        Text,
+        /// Input: a record of native 64 bit integers per row.
+        /// Output: a record of native 64 bit integers per row, the results followed by a bit mask of the functions with a division by zero.
+        Binary
+    };
+    /// The options.
+    struct Options {
+        /// The format.
+        Format format = Format::Text;
+        /// The number of rows evaluated at once.
+        size_t batch_size = 4096;
+        /// The number of bytes read and written at once.
+        size_t chunk_size = 1 << 20;
+    };
+    /// The counters of a run.
+    struct Statistics {
+        /// The number of rows.
+        uint64_t rows = 0;
+        /// The number of batches.
+        uint64_t batches = 0;
+        /// The number of results with a division by zero error.
+        uint64_t division_by_zero_errors = 0;
+    };
+    /// The maximum number of functions of the binary format.
+    static constexpr size_t max_binary_functions = 64;
+
+    /// Constructor.
+    explicit BatchServer(std::vector<FunctionHandle> functions);
+    /// Constructor.
+    BatchServer(std::vector<FunctionHandle> functions, Options options);
+    /// Evaluate the functions for all rows of the input until its end.
+    /// @return True for success, false for failure (compilation error, different numbers of parameters, malformed input or write error).
+    bool Serve(std::istream& in, std::ostream& out);
+    /// Get the counters of the last run.
+    [[nodiscard]] const Statistics& GetStatistics() const;
+
+    private:
+    /// The functions.
+    std::vector<FunctionHandle> functions;
+    /// The options.
+    Options options;
+    /// The counters.
+    Statistics statistics;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,48 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/JIT.hpp"
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+//---------------------------------------------------------------------------
+// Only for translation units compiled with coroutines, independent of the standard the library is compiled with.
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// The awaitable of an asynchronous call, see `Await`.
+class CallAwaitable {
+    public:
+    /// Constructor.
+    CallAwaitable(FunctionHandle function, std::vector<int64_t> arguments) : function(function), arguments(std::move(arguments)) {}
+    /// The call is always asynchronous.
+    [[nodiscard]] bool await_ready() const noexcept { return false; }
+    /// Submit the call, which resumes the coroutine with its return value.
+    void await_suspend(std::coroutine_handle<> coroutine) {
+        // The coroutine may resume before the submission returns, so the awaitable is not used afterwards.
+        function.CallAsync(std::move(arguments), [this, coroutine](std::optional<int64_t> value) {
+            result = value;
+            coroutine.resume();
+        });
+    }
+    /// Get the return value, see `FunctionHandle::Call`.
+    std::optional<int64_t> await_resume() const noexcept { return result; }
+
+    private:
+    /// The function.
+    FunctionHandle function;
+    /// The arguments.
+    std::vector<int64_t> arguments;
+    /// The return value.
+    std::optional<int64_t> result;
+};
+//---------------------------------------------------------------------------
+/// Call the function on the JIT's executor inside a coroutine: `co_await Await(function, arguments)` suspends until the return value is available.
+/// The coroutine resumes on the executor's thread.
+inline CallAwaitable Await(FunctionHandle function, std::vector<int64_t> arguments) { return CallAwaitable(function, std::move(arguments)); }
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#endif
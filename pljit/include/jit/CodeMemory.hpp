@@ -0,0 +1,98 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A code heap: mmaps large regions and sub-allocates function bodies from them.
+/// The regions are either writable or executable, never both (W^X). Their permissions are flipped in bulk,
+/// so many functions are emitted between two flips. Freed code is reused for later allocations.
+class CodeMemory {
+    public:
+    /// The usage counters.
+    struct Statistics {
+        /// The number of mapped regions.
+        size_t regions = 0;
+        /// The number of mapped bytes.
+        size_t mapped_bytes = 0;
+        /// The number of allocated bytes, without alignment padding.
+        size_t allocated_bytes = 0;
+        /// The number of live allocations.
+        size_t allocations = 0;
+        /// The number of permission flips.
+        size_t protection_changes = 0;
+    };
+    /// The default size of a region.
+    static constexpr size_t default_region_size = size_t(2) << 20;
+    /// The default alignment of a function body.
+    static constexpr size_t default_alignment = 16;
+    /// The size of a huge page.
+    static constexpr size_t huge_page_size = size_t(2) << 20;
+
+    /// Constructor. With `huge_pages` the regions are advised to be backed by transparent huge pages to reduce iTLB misses.
+    explicit CodeMemory(size_t region_size = default_region_size, bool huge_pages = false);
+    /// Destructor, unmaps all regions.
+    ~CodeMemory();
+    CodeMemory(const CodeMemory&) = delete;
+    CodeMemory& operator=(const CodeMemory&) = delete;
+
+    /// Allocate `size` bytes aligned to `alignment` (a power of two).
+    /// The memory may only be written while the code memory is writable.
+    /// @return The memory, nullptr if mapping failed.
+    uint8_t* Allocate(size_t size, size_t alignment = default_alignment);
+    /// Free an allocation for reuse.
+    void Free(uint8_t* code);
+    /// Make all regions writable and not executable.
+    /// @return True for success, false for failure.
+    bool MakeWritable();
+    /// Make all regions executable and not writable, flushing the instruction cache.
+    /// @return True for success, false for failure.
+    bool MakeExecutable();
+    /// If the regions are executable.
+    [[nodiscard]] bool IsExecutable() const;
+    /// Get the usage counters.
+    [[nodiscard]] Statistics GetStatistics() const;
+
+    private:
+    /// A mapped region.
+    struct Region {
+        /// The first byte.
+        uint8_t* begin;
+        /// The size in bytes.
+        size_t size;
+    };
+
+    /// The mutex.
+    mutable std::mutex mutex;
+    /// The size of a region.
+    const size_t region_size;
+    /// If huge pages are advised.
+    const bool huge_pages;
+    /// The page size.
+    const size_t page_size;
+    /// The mapped regions.
+    std::vector<Region> regions;
+    /// The free blocks: begin -> size, adjacent blocks are merged.
+    std::map<uint8_t*, size_t> free_blocks;
+    /// The allocations: begin -> size.
+    std::unordered_map<uint8_t*, size_t> allocations;
+    /// If the regions are executable.
+    bool executable = false;
+    /// The usage counters.
+    Statistics statistics;
+
+    /// Map a region of at least `size` bytes and add it to the free blocks. The caller holds the mutex.
+    bool MapRegion(size_t size);
+    /// Add a free block, merging it with its neighbours. The caller holds the mutex.
+    void AddFreeBlock(uint8_t* begin, size_t size);
+    /// Set the protection of all regions. The caller holds the mutex.
+    bool Protect(bool make_executable);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,82 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/JIT.hpp"
+#include "util/MappedFile.hpp"
+#include "util/ThreadPool.hpp"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Evaluates a function over columns of arguments, a column per parameter.
+/// The rows are split into morsels, which a work-stealing thread pool distributes, so a slow thread does not hold up the others.
+/// Column files hold raw little-endian 64 bit integers and are memory-mapped, so neither the arguments nor the results are copied.
+class ColumnEvaluator {
+    public:
+    /// The options.
+    struct Options {
+        /// The number of threads, 0 for the number of hardware threads.
+        size_t threads = 0;
+        /// The number of rows a thread takes at once. The default keeps a morsel's columns of a few parameters in the L2 cache.
+        size_t morsel_rows = size_t(1) << 14;
+    };
+    /// The counters of a run.
+    struct Statistics {
+        /// The number of rows.
+        uint64_t rows = 0;
+        /// The number of morsels.
+        uint64_t morsels = 0;
+        /// The number of threads.
+        uint64_t threads = 0;
+        /// The number of rows with a division by zero error.
+        uint64_t division_by_zero_errors = 0;
+    };
+
+    /// Constructor.
+    explicit ColumnEvaluator(FunctionHandle function);
+    /// Constructor.
+    ColumnEvaluator(FunctionHandle function, Options options);
+    /// Evaluate the function for `number_of_rows` rows of the columns.
+    /// A row with a division by zero gets result 0 and, if `errors` is not nullptr, error 1.
+    /// @return True for success, false for failure (compilation error or a wrong number of columns).
+    bool Evaluate(const std::vector<const int64_t*>& columns, size_t number_of_rows, int64_t* results, uint8_t* errors = nullptr);
+    /// Evaluate the function for the column files, writing the results to a column file and, if `errors_path` is not empty,
+    /// the division by zero errors to a file of a byte per row.
+    /// @return True for success, false for failure (compilation error, I/O error, or columns of different lengths).
+    bool EvaluateFiles(const std::vector<std::string>& input_paths, const std::string& output_path, const std::string& errors_path = {});
+    /// Evaluate the function for `number_of_rows` rows of the columns and add the results to the aggregates, without storing them.
+    /// @return True for success, false for failure (compilation error or a wrong number of columns).
+    bool Aggregate(const std::vector<const int64_t*>& columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates);
+    /// Evaluate the function for the column files and add the results to the aggregates.
+    /// @return True for success, false for failure (compilation error, I/O error, or columns of different lengths).
+    bool AggregateFiles(const std::vector<std::string>& input_paths, const Aggregation& aggregation, Aggregates& aggregates);
+    /// Get the counters of the last run.
+    [[nodiscard]] const Statistics& GetStatistics() const;
+
+    private:
+    /// The function.
+    FunctionHandle function;
+    /// The options.
+    Options options;
+    /// The counters.
+    Statistics statistics;
+    /// The thread pool, created by the first run and kept for the next ones.
+    std::unique_ptr<ThreadPool> thread_pool;
+
+    /// Processes a morsel given the thread's index, the morsel's columns, its first row and its number of rows.
+    using MorselFunction = std::function<bool(size_t thread, const int64_t* const* columns, size_t begin, size_t number_of_rows)>;
+    /// Get the number of threads, the morsels may be fewer.
+    [[nodiscard]] size_t GetMaxThreads() const;
+    /// Split the rows into morsels and process them on the threads.
+    /// @return True for success, false for failure (compilation error, a wrong number of columns or a failed morsel).
+    bool ForEachMorsel(const std::vector<const int64_t*>& columns, size_t number_of_rows, const MorselFunction& process);
+    /// Map the column files.
+    /// @return True for success, false for failure (I/O error or columns of different lengths).
+    static bool MapColumns(const std::vector<std::string>& input_paths, std::vector<MappedFile>& inputs, std::vector<const int64_t*>& columns, size_t& number_of_rows);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
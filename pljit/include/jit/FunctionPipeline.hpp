@@ -0,0 +1,57 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/IR.hpp"
+#include "jit/JIT.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A chain of functions, in which the result of a function is a parameter of the next one.
+/// The chain is compiled into one function by inlining the functions' IR, so constants are folded and common computations are shared across the functions.
+/// It takes the parameters of the first function followed by the parameters of the next ones, without the parameters fed by the previous function.
+/// A division by zero in any function fails the row.
+class FunctionPipeline {
+    public:
+    /// Constructor.
+    explicit FunctionPipeline(FunctionHandle function);
+    /// Feed the result of the chain into the parameter `parameter` of `function`, which becomes the end of the chain.
+    FunctionPipeline& Then(FunctionHandle function, std::string parameter);
+    /// Compile the chain, if it is not compiled yet. Call it before calling on several threads.
+    /// @return True for success, false for failure (compilation error or an unknown parameter).
+    bool Compile();
+    /// Get the number of parameters of the chain.
+    /// @return The number of parameters, std::nullopt for a compilation error.
+    std::optional<size_t> GetNumberOfParameters();
+    /// Get the IR of the chain, nullptr if it is not compiled.
+    [[nodiscard]] const IRFunction* GetIR() const;
+
+    /// Call the chain with the arguments, see `FunctionHandle::Call`.
+    /// @return The return value, std::nullopt for a compilation, argument count or division by zero error.
+    std::optional<int64_t> Call(const int64_t* arguments, size_t number_of_arguments);
+    /// Call the chain for a batch of rows, see `FunctionHandle::CallBatch`.
+    /// @return True for success, false for failure (compilation error).
+    bool CallBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors);
+    /// Call the chain for a batch of rows stored column-wise, see `FunctionHandle::CallColumns`.
+    /// @return True for success, false for failure (compilation error).
+    bool CallColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors);
+
+    private:
+    /// A function of the chain.
+    struct Stage {
+        /// The function.
+        FunctionHandle function;
+        /// The parameter fed by the previous function, empty for the first function.
+        std::string parameter;
+    };
+    /// The functions.
+    std::vector<Stage> stages;
+    /// The IR of the chain, nullptr if it is not compiled.
+    std::unique_ptr<IRFunction> ir;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// The execution tier of a function.
+enum class Tier : uint8_t {
+    /// Not compiled yet, or the compilation failed.
+    Uncompiled,
+    /// The optimized AST is evaluated.
+    Interpreted,
+    /// The function returns a constant without evaluation.
+    Constant,
+};
+//---------------------------------------------------------------------------
+/// The compilation phases.
+enum class CompilePhase : uint8_t {
+    /// Lexing and parsing to the parse tree.
+    Parse,
+    /// The semantic analysis to the AST.
+    SemanticAnalysis,
+    /// Binding parameters and the optimization pipeline.
+    Optimization,
+};
+//---------------------------------------------------------------------------
+/// The runtime counters of a function.
+/// The call counters are sharded by thread, so concurrent callers do not contend on a cache line.
+/// The shards are allocated by the first call, so the many functions, which are never called, do not pay for them.
+class FunctionStatistics {
+    public:
+    /// The number of compilation phases.
+    static constexpr size_t number_of_phases = 3;
+    /// A copy of the counters.
+    struct Snapshot {
+        /// The number of calls.
+        uint64_t calls = 0;
+        /// The cumulative evaluation time of all calls in nanoseconds.
+        uint64_t total_evaluation_ns = 0;
+        /// The longest evaluation time of a call in nanoseconds.
+        uint64_t max_evaluation_ns = 0;
+        /// The number of calls failing with a division by zero.
+        uint64_t division_by_zero_errors = 0;
+        /// The compilation time per phase in nanoseconds, indexed by `CompilePhase`.
+        std::array<uint64_t, number_of_phases> compile_ns = {};
+        /// The number of heap allocations per compilation phase. 0 without `AllocationTracker`.
+        std::array<uint64_t, number_of_phases> compile_allocations = {};
+        /// The peak transient heap memory per compilation phase in bytes. 0 without `AllocationTracker`.
+        std::array<uint64_t, number_of_phases> compile_peak_bytes = {};
+        /// The current tier.
+        Tier tier = Tier::Uncompiled;
+    };
+
+    /// Constructor.
+    FunctionStatistics() = default;
+    /// Destructor.
+    ~FunctionStatistics();
+    FunctionStatistics(const FunctionStatistics&) = delete;
+    FunctionStatistics& operator=(const FunctionStatistics&) = delete;
+
+    /// Record a call.
+    void RecordCall(uint64_t evaluation_ns, bool division_by_zero);
+    /// Record a batch of calls. The maximum evaluation time is not updated, as the rows are not timed individually.
+    void RecordBatch(uint64_t rows, uint64_t evaluation_ns, uint64_t division_by_zero_errors);
+    /// Record the time, the number of allocations and the peak memory of a compilation phase.
+    void RecordCompilePhase(CompilePhase phase, uint64_t ns, uint64_t allocations = 0, uint64_t peak_bytes = 0);
+    /// Set the current tier.
+    void SetTier(Tier tier);
+    /// Read the counters.
+    [[nodiscard]] Snapshot GetSnapshot() const;
+    /// Get the bytes of the shards, 0 before the first call.
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    private:
+    /// The number of shards.
+    static constexpr size_t number_of_shards = 16;
+    /// The counters of the threads mapped to a shard.
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> calls = 0;
+        std::atomic<uint64_t> total_evaluation_ns = 0;
+        std::atomic<uint64_t> max_evaluation_ns = 0;
+        std::atomic<uint64_t> division_by_zero_errors = 0;
+    };
+
+    /// The shards, nullptr before the first call.
+    std::atomic<Shard*> shards = nullptr;
+    /// The compilation times.
+    std::array<std::atomic<uint64_t>, number_of_phases> compile_ns = {};
+    /// The allocations of the compilation phases.
+    std::array<std::atomic<uint64_t>, number_of_phases> compile_allocations = {};
+    /// The peak memory of the compilation phases.
+    std::array<std::atomic<uint64_t>, number_of_phases> compile_peak_bytes = {};
+    /// The current tier.
+    std::atomic<Tier> tier = Tier::Uncompiled;
+
+    /// Get the shard of the calling thread.
+    Shard& GetShard();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,50 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/IR.hpp"
+#include "jit/JIT.hpp"
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Evaluates several functions with the same parameters in one pass over the rows.
+/// The functions' IR is fused, so the parameters are loaded once and a computation common to several functions is evaluated once.
+/// Every function gets its own results and errors, a division by zero only fails the functions dividing by the zero.
+class FusedKernel {
+    public:
+    /// Constructor.
+    explicit FusedKernel(std::vector<FunctionHandle> functions);
+    /// Compile the functions and fuse them, if it is not done yet. Call it before evaluating on several threads.
+    /// @return True for success, false for failure (compilation error or different numbers of parameters).
+    bool Compile();
+    /// Evaluate the functions for a batch of rows, see `FunctionHandle::CallBatch`.
+    /// `results` and `errors` hold a column of `number_of_rows` values per function.
+    /// @return True for success, false for failure (compilation error or different numbers of parameters).
+    bool EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors);
+    /// Evaluate the functions for a batch of rows stored column-wise, see `FunctionHandle::CallColumns`.
+    /// @return True for success, false for failure (compilation error or different numbers of parameters).
+    bool EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors);
+    /// Get the number of functions.
+    [[nodiscard]] size_t GetNumberOfFunctions() const;
+    /// Get the number of parameters, which the functions are compiled for.
+    /// @return The number of parameters, std::nullopt for a compilation error.
+    std::optional<size_t> GetNumberOfParameters();
+    /// Get the fused IR, nullptr if it is not compiled.
+    [[nodiscard]] const FusedIRFunction* GetIR() const;
+
+    private:
+    /// The functions.
+    std::vector<FunctionHandle> functions;
+    /// The runtime counters of the functions, which get the batches.
+    std::vector<FunctionStatistics*> statistics;
+    /// The fused IR, nullptr if it is not compiled.
+    std::unique_ptr<FusedIRFunction> ir;
+
+    /// Evaluate a batch of rows given as row-major `arguments` or, if they are nullptr, as `columns`.
+    bool EvaluateRows(const int64_t* arguments, const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
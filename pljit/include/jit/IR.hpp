@@ -0,0 +1,285 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "ast/ASTNode.hpp"
+#include "ast/ASTNodeVisitor.hpp"
+#include "ast/SymbolTable.hpp"
+#include <cstdint>
+#include <iosfwd>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// An instruction of the intermediate representation.
+/// Each instruction but "RETURN" defines a new virtual register (static single assignment), operands are virtual registers.
+struct Instruction {
+    /// The operation codes.
+    enum class Opcode : uint8_t {
+        /// destination := value.
+        Constant,
+        /// destination := argument[value].
+        Parameter,
+        /// destination := -left.
+        Negate,
+        /// destination := left + right.
+        Add,
+        /// destination := left - right.
+        Sub,
+        /// destination := left * right.
+        Mul,
+        /// destination := left / right, fails if right is 0.
+        Div,
+        /// return left.
+        Return
+    };
+    /// The operation.
+    Opcode opcode;
+    /// The defined virtual register.
+    uint32_t destination = 0;
+    /// The left operand.
+    uint32_t left = 0;
+    /// The right operand.
+    uint32_t right = 0;
+    /// The constant value or the parameter index.
+    int64_t value = 0;
+};
+//---------------------------------------------------------------------------
+/// The aggregates to compute over the results of a batch, besides the count, the sum, the minimum and the maximum.
+struct Aggregation {
+    /// The lower bound of the first histogram bucket. Smaller values are counted in the first bucket.
+    int64_t histogram_lower = 0;
+    /// The width of a histogram bucket, 0 for no histogram.
+    uint64_t histogram_width = 0;
+    /// The number of histogram buckets, 0 for no histogram. Larger values are counted in the last bucket.
+    size_t histogram_buckets = 0;
+};
+//---------------------------------------------------------------------------
+/// The aggregates of the results of the rows without a division by zero.
+struct Aggregates {
+    /// The number of rows without a division by zero.
+    uint64_t count = 0;
+    /// The number of rows with a division by zero.
+    uint64_t errors = 0;
+    /// The sum, which wraps around on overflow.
+    int64_t sum = 0;
+    /// The minimum, the largest integer without rows.
+    int64_t min = std::numeric_limits<int64_t>::max();
+    /// The maximum, the smallest integer without rows.
+    int64_t max = std::numeric_limits<int64_t>::min();
+    /// The number of rows per histogram bucket, empty without a histogram.
+    std::vector<uint64_t> histogram;
+
+    /// Add the aggregates of other rows.
+    void Merge(const Aggregates& other);
+};
+//---------------------------------------------------------------------------
+/// A function in the intermediate representation: a straight-line sequence of instructions ending with "RETURN".
+/// It is the common input of the backends, independent of the AST's evaluation contexts.
+class IRFunction {
+    public:
+    /// The number of rows a batch evaluation processes at once, so the registers of a block stay in the L1 cache.
+    static constexpr size_t batch_block_size = 256;
+
+    /// Constructor.
+    IRFunction(std::vector<Instruction> instructions, uint32_t number_of_registers, size_t number_of_parameters);
+    /// Get the instructions.
+    [[nodiscard]] const std::vector<Instruction>& GetInstructions() const;
+    /// Get the number of virtual registers.
+    [[nodiscard]] uint32_t GetNumberOfRegisters() const;
+    /// Get the number of parameters.
+    [[nodiscard]] size_t GetNumberOfParameters() const;
+    /// Evaluate the function: the reference interpreter of the IR.
+    /// @return The return value, std::nullopt for a division by zero error.
+    [[nodiscard]] std::optional<int64_t> Evaluate(const int64_t* arguments) const;
+    /// Evaluate the function for a batch of rows, one instruction at a time for a block of rows.
+    /// The arguments are row-major, `GetNumberOfParameters()` per row. A row with a division by zero gets error 1 and result 0.
+    /// @return The number of rows with a division by zero error.
+    size_t EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors) const;
+    /// Evaluate the function for a batch of rows stored column-wise, a column of `number_of_rows` values per parameter.
+    /// A parameter marked in `scalar_parameters` has the same value in all rows, and its column is that single value.
+    /// The computations depending only on constants and scalar parameters run once per batch instead of once per row.
+    /// @return The number of rows with a division by zero error.
+    size_t EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors, const std::vector<bool>* scalar_parameters = nullptr) const;
+    /// Evaluate the function for a batch of rows and add the results to the aggregates, without storing them.
+    /// The arguments are row-major like `EvaluateBatch`.
+    void AggregateBatch(const int64_t* arguments, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates) const;
+    /// Evaluate the function for a batch of rows stored column-wise and add the results to the aggregates.
+    void AggregateColumns(const int64_t* const* columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates, const std::vector<bool>* scalar_parameters = nullptr) const;
+    /// Evaluate the function as a predicate for a batch of rows, and store the indexes of the rows with a non-zero result in `selection`.
+    /// The rows with a division by zero are not selected. `selection` has room for `number_of_rows` indexes, which are at most 2^32.
+    /// The arguments are row-major like `EvaluateBatch`.
+    /// @return The number of selected rows.
+    size_t SelectBatch(const int64_t* arguments, size_t number_of_rows, uint32_t* selection, size_t& number_of_errors) const;
+    /// Evaluate the function as a predicate for a batch of rows stored column-wise, see `SelectBatch`.
+    /// @return The number of selected rows.
+    size_t SelectColumns(const int64_t* const* columns, size_t number_of_rows, uint32_t* selection, size_t& number_of_errors, const std::vector<bool>* scalar_parameters = nullptr) const;
+    /// Print the instructions, one per line, e.g. "%2 = mul %0, %1".
+    void Print(std::ostream& out) const;
+
+    private:
+    /// The instructions.
+    std::vector<Instruction> instructions;
+    /// The number of virtual registers.
+    uint32_t number_of_registers;
+    /// The number of parameters.
+    size_t number_of_parameters;
+
+    /// Where the results of the blocks go: the results and errors are stored, aggregated, or the selected rows are stored.
+    struct Sink {
+        /// The results, nullptr if they are not stored.
+        int64_t* results = nullptr;
+        /// The errors, if the results are stored.
+        uint8_t* errors = nullptr;
+        /// The aggregation, if the results are aggregated.
+        const Aggregation* aggregation = nullptr;
+        /// The aggregates, nullptr if the results are not aggregated.
+        Aggregates* aggregates = nullptr;
+        /// The indexes of the selected rows, nullptr if the rows are not selected.
+        uint32_t* selection = nullptr;
+        /// The number of selected rows.
+        size_t selected = 0;
+    };
+
+    /// Evaluate row-major arguments.
+    /// @return The number of rows with a division by zero error, unless they are aggregated.
+    size_t EvaluateRowMajor(const int64_t* arguments, size_t number_of_rows, Sink& sink) const;
+    /// Evaluate blocks of rows. The value of parameter p in row r is `parameters[p][r * stride]`, or `parameters[p][0]` for a scalar parameter.
+    /// @return The number of rows with a division by zero error, unless they are aggregated.
+    size_t EvaluateBlocks(const int64_t* const* parameters, size_t stride, size_t number_of_rows, Sink& sink, const std::vector<bool>* scalar_parameters = nullptr) const;
+};
+//---------------------------------------------------------------------------
+/// Several functions with the same parameters fused into one straight-line sequence of instructions without "RETURN".
+/// The functions share the parameter loads and the identical computations, and each one defines an output.
+class FusedIRFunction {
+    public:
+    /// The result of a function.
+    struct Output {
+        /// The virtual register of the return value.
+        uint32_t value;
+        /// The virtual registers of the divisors of the function's divisions, which may be 0.
+        /// A division shared with another function only fails the functions dividing.
+        std::vector<uint32_t> divisors;
+    };
+
+    /// Constructor.
+    FusedIRFunction(std::vector<Instruction> instructions, std::vector<Output> outputs, uint32_t number_of_registers, size_t number_of_parameters);
+    /// Get the instructions.
+    [[nodiscard]] const std::vector<Instruction>& GetInstructions() const;
+    /// Get the outputs, one per function.
+    [[nodiscard]] const std::vector<Output>& GetOutputs() const;
+    /// Get the number of parameters.
+    [[nodiscard]] size_t GetNumberOfParameters() const;
+    /// Evaluate all functions for a batch of rows, see `IRFunction::EvaluateBatch`.
+    /// `results` and `errors` hold a column per function, `number_of_errors` a counter per function, which is incremented.
+    void EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const;
+    /// Evaluate all functions for a batch of rows stored column-wise, see `IRFunction::EvaluateColumns`.
+    void EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const;
+    /// Print the instructions and the outputs.
+    void Print(std::ostream& out) const;
+
+    private:
+    /// The instructions.
+    std::vector<Instruction> instructions;
+    /// The outputs.
+    std::vector<Output> outputs;
+    /// The number of virtual registers.
+    uint32_t number_of_registers;
+    /// The number of parameters.
+    size_t number_of_parameters;
+
+    /// Evaluate blocks of rows. The value of parameter p in row r is `parameters[p][r * stride]`.
+    void EvaluateBlocks(const int64_t* const* parameters, size_t stride, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const;
+};
+//---------------------------------------------------------------------------
+/// A visitor lowers an (optimized) AST into the intermediate representation.
+/// Variables are renamed to the virtual register of their last assignment, identical computations are numbered to the same register.
+class IRBuilder : public ASTNodeVisitor {
+    public:
+    /// Constructor.
+    IRBuilder(const SymbolTable& symbol_table, const std::vector<std::string_view>& parameters);
+    /// Constructor for fusing functions with `AddFunction` or inlining them with `AddInlined`.
+    IRBuilder() = default;
+    /// Lower the AST.
+    IRFunction Build(FunctionAST& node);
+    /// Add a lowered function to the fused functions. The functions take the same number of parameters.
+    void AddFunction(const IRFunction& function);
+    /// Get the fused functions.
+    FusedIRFunction BuildFused();
+    /// Emit a parameter of the function built with `BuildReturn`.
+    uint32_t AddParameter(size_t index);
+    /// Inline a lowered function, whose parameter i is the virtual register `arguments[i]`.
+    /// @return The virtual register of the function's return value.
+    uint32_t AddInlined(const IRFunction& function, const std::vector<uint32_t>& arguments);
+    /// Get the function returning the virtual register `value`.
+    /// The instructions neither contributing to the value nor to a division, which may fail, are dropped.
+    IRFunction BuildReturn(uint32_t value, size_t function_parameters);
+
+    private:
+    /// The key of an instruction for the value numbering.
+    struct Key {
+        /// The operation.
+        Instruction::Opcode opcode;
+        /// The left operand.
+        uint32_t left;
+        /// The right operand.
+        uint32_t right;
+        /// The value.
+        int64_t value;
+        /// Equality.
+        bool operator==(const Key& other) const { return opcode == other.opcode && left == other.left && right == other.right && value == other.value; }
+    };
+    /// The hash of a key.
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    /// The symbol table, nullptr when fusing.
+    const SymbolTable* symbol_table = nullptr;
+    /// The parameters' names in declaration order, nullptr when fusing.
+    const std::vector<std::string_view>* parameters = nullptr;
+    /// The number of parameters of the fused functions.
+    size_t number_of_parameters = 0;
+    /// The emitted instructions.
+    std::vector<Instruction> instructions;
+    /// The value numbering: instruction -> virtual register.
+    std::unordered_map<Key, uint32_t, KeyHash> values;
+    /// The current virtual register of each identifier.
+    std::unordered_map<std::string_view, uint32_t> identifiers;
+    /// The virtual register of the last visited expression.
+    uint32_t result = 0;
+    /// If a "RETURN" was lowered.
+    bool returned = false;
+    /// If functions are fused: a "RETURN" defines an output instead of an instruction.
+    bool fused = false;
+    /// The divisors of the current function, when fusing.
+    std::vector<uint32_t> divisors;
+    /// The outputs of the fused functions.
+    std::vector<FusedIRFunction::Output> outputs;
+
+    /// Emit an instruction, or reuse the register of an identical one. An operation of constants is folded into a constant.
+    uint32_t Emit(Instruction::Opcode opcode, uint32_t left, uint32_t right, int64_t value);
+    /// Emit the instructions of a lowered function, whose parameter i is `arguments[i]` or, without arguments, the parameter i.
+    /// @return The virtual register of the function's return value.
+    uint32_t Copy(const IRFunction& function, const uint32_t* arguments);
+
+    /// IR Visit methods for the IdentifierPrimaryExpressionAST.
+    void Visit(IdentifierPrimaryExpressionAST& node) override;
+    /// IR Visit methods for the LiteralPrimaryExpressionAST.
+    void Visit(LiteralPrimaryExpressionAST& node) override;
+    /// IR Visit methods for the UnaryExpressionAST.
+    void Visit(UnaryExpressionAST& node) override;
+    /// IR Visit methods for the BinaryExpressionAST.
+    void Visit(BinaryExpressionAST& node) override;
+    /// IR Visit methods for the AssignmentStatementAST.
+    void Visit(AssignmentStatementAST& node) override;
+    /// IR Visit methods for the ReturnStatementAST.
+    void Visit(ReturnStatementAST& node) override;
+    /// IR Visit methods for the FunctionAST.
+    void Visit(FunctionAST& node) override;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
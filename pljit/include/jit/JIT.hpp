@@ -2,6 +2,19 @@
 //---------------------------------------------------------------------------
 #include "ast/ASTNode.hpp"
 #include "optimization/EvaluationContext.hpp"
+#include "optimization/ParameterBinding.hpp"
+#include "optimization/PassManager.hpp"
+#include "jit/FunctionStatistics.hpp"
+#include "jit/IR.hpp"
+#include "jit/ResultCache.hpp"
+#include "util/Executor.hpp"
+#include "util/InstrumentedMutex.hpp"
+#include "util/ThreadPool.hpp"
+#include "util/Trace.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <future>
 #include <mutex>
 #include <iostream>
 #include <optional>
@@ -13,30 +26,140 @@ class FunctionHandle;
 /// JIT-class: handles registering functions and their source code
 class JIT {
     friend class FunctionHandle;
+    friend class FusedKernel;
+    friend class FunctionPipeline;
+    public:
+    /// The counters of the JIT's mutexes.
+    struct LockStatistics {
+        /// The register mutex.
+        InstrumentedMutex::Statistics register_mutex;
+        /// The functions' mutexes, summed up.
+        InstrumentedMutex::Statistics function_mutexes;
+    };
+    /// The bytes retained by a function.
+    struct MemoryUsage {
+        /// The source code.
+        size_t source = 0;
+        /// The optimized AST.
+        size_t ast = 0;
+        /// The parameter names, bindings, names and the rest of the function's slot.
+        size_t symbol_table = 0;
+        /// The evaluation context, which is copied for every call.
+        size_t frame_template = 0;
+        /// The result cache.
+        size_t result_cache = 0;
+        /// The lowered code: the IR of the batch evaluation.
+        size_t code = 0;
+        /// The call counters, which are allocated by the first call.
+        size_t statistics = 0;
+
+        /// Get the sum of all parts.
+        [[nodiscard]] size_t GetTotal() const { return source + ast + symbol_table + frame_template + result_cache + code + statistics; }
+        /// Add the memory of another function.
+        MemoryUsage& operator+=(const MemoryUsage& other);
+    };
+
     private:
     /// The Register mutex.
-    std::mutex register_mutex;
-    /// The codes.
-    std::vector<std::unique_ptr<SourceCodeManagement>> codes;
+    InstrumentedMutex register_mutex;
+    /// The pass manager optimizing the functions.
+    PassManager pass_manager;
+    /// The recorder of the compilation and call spans, nullptr if tracing is disabled.
+    std::atomic<TraceRecorder*> trace_recorder = nullptr;
+    /// A registered function.
+    struct FunctionSlot {
+        /// The code.
+        std::unique_ptr<SourceCodeManagement> code;
+        /// The function's mutex.
+        InstrumentedMutex mutex;
+        /// The flag, if compiled.
+        bool compiled = false;
+        /// The ast.
+        std::unique_ptr<FunctionAST> ast;
+        /// The Evaluation Context.
+        std::unique_ptr<EvaluationContext> ec;
+        /// The IR of the optimized AST, which evaluates batches.
+        std::unique_ptr<IRFunction> ir;
+        /// The parameters' names in declaration order, without the bound ones.
+        std::vector<std::string_view> parameters;
+        /// The bound parameters of specialized functions.
+        ParameterBinding::Bindings bindings;
+        /// The result cache, nullptr if not enabled.
+        std::unique_ptr<ResultCache> cache;
+        /// The return value of a constant function, which is returned without evaluation.
+        std::optional<int64_t> constant;
+        /// The optimization pipeline's name.
+        std::string pipeline;
+        /// The user-supplied name of the function, empty for the default name.
+        std::string name;
+        /// The runtime counters.
+        FunctionStatistics statistics;
+    };
+    /// The functions. The slots never move, so they can be used without the register mutex once looked up.
+    std::vector<std::unique_ptr<FunctionSlot>> functions;
+    /// The threads of the batch evaluations, 0 for the number of hardware threads.
+    size_t batch_threads = 0;
+    /// The number of rows of a morsel, which a thread of a batch evaluation takes at once.
+    size_t batch_morsel_rows = default_morsel_rows;
+    /// The thread pool of the batch evaluations, created by the first batch of more than one morsel. Shared with the running batches,
+    /// so replacing it does not destroy it under them.
+    std::shared_ptr<ThreadPool> thread_pool;
+    /// The threads of the asynchronous calls, 0 for the number of hardware threads. Protected by the executor mutex.
+    size_t async_threads = 0;
+    /// Protects the executor, so a submission never waits for the register mutex, which is held during compilations.
+    std::mutex executor_mutex;
+    /// The replaced executors, which could not be destroyed by the thread replacing them, as it was one of their threads.
+    std::vector<std::unique_ptr<Executor>> retired_executors;
+    /// The executor of the asynchronous calls, created by the first one. Destroyed first, so its remaining calls still find the functions.
+    std::unique_ptr<Executor> executor;
 
-    /// The function's mutexes.
-    std::vector<std::unique_ptr<std::mutex>> mutexes;
-    /// The flag, if compiled.
-    std::vector<bool> flags;
-    /// The asts.
-    std::vector<std::unique_ptr<FunctionAST>> asts;
-    /// The Evaluation Contextes.
-    std::vector<std::unique_ptr<EvaluationContext>> ecs;
+    /// Get the bytes retained by a function. The caller holds the register mutex.
+    static MemoryUsage GetMemoryUsage(const FunctionSlot& slot);
+    /// Register the function with bound parameters. The caller holds the register mutex.
+    FunctionHandle RegisterFunction(const SourceCodeManagement& code, std::string pipeline, ParameterBinding::Bindings bound_parameters);
+    /// Run a job on the executor of the asynchronous calls.
+    void SubmitAsync(Executor::Job job);
 
     public:
+    /// The default number of rows of a morsel.
+    static constexpr size_t default_morsel_rows = size_t(1) << 14;
+
     /// Constructor.
     JIT() = default;
     /// Register function returning function handle, which is only compiled when it is called.
-    FunctionHandle RegisterFunction(const std::string& code);
+    /// Cold functions called once may skip the optimization with `O0`, hot ones get the full pipeline with `O3`.
+    FunctionHandle RegisterFunction(const std::string& code, OptimizationLevel level = OptimizationLevel::O2);
+    /// Register function optimized by a named pipeline of the pass manager.
+    FunctionHandle RegisterFunction(const std::string& code, std::string pipeline);
+    /// Add a named pipeline of optimization passes, see `PassManager::AddPipeline`.
+    bool AddPipeline(std::string name, std::vector<std::string> passes, size_t max_iterations = 1);
+    /// Specialize a function by binding a subset of its parameters to constants.
+    /// The returned function handle only takes the remaining parameters. It is compiled immediately with the same pipeline, so the folding cost is paid once.
+    /// @return The specialized function, std::nullopt for a compilation error, a name that is not a parameter or a parameter, which is already bound.
+    std::optional<FunctionHandle> Specialize(const FunctionHandle& function, const ParameterBinding::Bindings& bound_parameters);
+    /// Record the compilation phases and calls in the trace recorder, which has to outlive the JIT. nullptr disables tracing.
+    void SetTraceRecorder(TraceRecorder* recorder);
+    /// Get the runtime counters of all registered functions, indexed by registration.
+    std::vector<FunctionStatistics::Snapshot> GetStatistics();
+    /// Get the acquisitions and waiting times of the mutexes.
+    LockStatistics GetLockStatistics();
+    /// Get the bytes retained by all registered functions.
+    MemoryUsage GetMemoryUsage();
+    /// Set the threads evaluating a batch of more than one morsel, 0 for the number of hardware threads and 1 to disable the parallel evaluation.
+    /// The morsels are distributed by a work-stealing thread pool. The running batches finish on the previous pool.
+    void SetBatchParallelism(size_t threads, size_t morsel_rows = default_morsel_rows);
+    /// Get the counters of the thread pool of the batch evaluations.
+    ThreadPool::Statistics GetThreadPoolStatistics();
+    /// Set the threads of the asynchronous calls, 0 for the number of hardware threads. The calls submitted before still run.
+    /// It may be called by a callback or a coroutine running on the executor: the previous executor is then kept until it can be joined.
+    void SetAsyncThreads(size_t threads);
 };
 //---------------------------------------------------------------------------
 /// A function handle for just-in-time compilation.
 class FunctionHandle {
+    friend class JIT;
+    friend class FusedKernel;
+    friend class FunctionPipeline;
     private:
     /// The JIT pointer.
     JIT* jit;
@@ -44,44 +167,82 @@ class FunctionHandle {
     const size_t index;
 
     /// The function compilation.
-    int Compile();
-
+    int Compile(JIT::FunctionSlot& slot);
+    /// Compile the function, if it is not compiled yet. The caller holds the register and the function's mutex.
+    /// @return True for success, false for failure.
+    bool CompileIfNeeded(JIT::FunctionSlot& slot);
+    /// Get the name of the function. The caller holds the register mutex.
+    [[nodiscard]] std::string GetName(const JIT::FunctionSlot& slot) const;
+    /// Compile the function, if it is not compiled yet.
+    /// @return True for success, false for failure.
+    bool EnsureCompiled();
+    /// Compile the function, if needed, evaluate a batch of rows and record it.
+    /// The rows are evaluated with `evaluate(slot, begin, rows)`, which returns the number of division by zero errors. A batch of more than one morsel
+    /// is split into morsels evaluated on the thread pool, so `evaluate` has to be thread-safe for disjoint rows.
+    /// @return True for success, false for failure (compilation error).
+    /// Fails, if `scalar_parameters` are given, but not one per parameter.
+    template <typename Evaluate>
+    bool RunBatch(size_t number_of_rows, const Evaluate& evaluate, const std::vector<bool>* scalar_parameters = nullptr);
     public:
     /// Constructor.
     FunctionHandle(JIT* jit, size_t index);
+    /// Enable the result cache in front of the evaluation, which is worthwhile for repeated arguments.
+    /// The function is compiled to know its parameters. Enabling an enabled cache keeps it.
+    /// @return True for success, false for failure (compilation error).
+    bool EnableResultCache(size_t capacity = ResultCache::default_capacity);
+    /// Get the hit and miss counters of the result cache. All zero, if it was never enabled.
+    ResultCache::Statistics GetResultCacheStatistics();
+    /// Set the name of the function, under which profilers show its generated code.
+    void SetName(std::string name);
+    /// Get the name of the function, `pljit_function_<index>` if none was set.
+    std::string GetName();
+    /// Get the runtime counters of the function.
+    FunctionStatistics::Snapshot GetStatistics();
+    /// Get the bytes retained by the function.
+    JIT::MemoryUsage GetMemoryUsage();
+    /// Get the number of parameters, which the function is compiled for.
+    /// @return The number of parameters, std::nullopt for a compilation error.
+    std::optional<size_t> GetNumberOfParameters();
 
+    /// Call the function with the arguments in parameters' declaration order.
+    /// @return The return value, std::nullopt for a compilation, argument count or division by zero error.
+    std::optional<int64_t> Call(const int64_t* arguments, size_t number_of_arguments);
+    /// Call the function for a batch of rows, which amortizes the locking and the dispatch over the rows.
+    /// The arguments are row-major, `GetNumberOfParameters()` per row. A row with a division by zero gets error 1 and result 0, it is not reported.
+    /// @return True for success, false for failure (compilation error).
+    bool CallBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors);
+    /// Call the function for a batch of rows stored column-wise, a column of `number_of_rows` values per parameter.
+    /// A parameter marked in `scalar_parameters` is the same for all rows, e.g. a rate or a scale factor, and its column is the single value.
+    /// The computations depending only on scalar parameters run once per batch.
+    /// @return True for success, false for failure (compilation error or a wrong number of scalar flags).
+    bool CallColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors, const std::vector<bool>* scalar_parameters = nullptr);
+    /// Call the function for a batch of rows like `CallBatch`, but add the results to the aggregates instead of storing them.
+    /// @return True for success, false for failure (compilation error).
+    bool Aggregate(const int64_t* arguments, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates);
+    /// Call the function for a batch of rows stored column-wise like `CallColumns`, but add the results to the aggregates.
+    /// @return True for success, false for failure (compilation error).
+    bool AggregateColumns(const int64_t* const* columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates,
+                          const std::vector<bool>* scalar_parameters = nullptr);
+    /// Call the function as a predicate for a batch of rows like `CallBatch`, and store the indexes of the rows with a non-zero result in `selection`.
+    /// The rows with a division by zero are not selected. `selection` has room for `number_of_rows` indexes.
+    /// @return True for success, false for failure (compilation error or more than 2^32 rows).
+    bool Select(const int64_t* arguments, size_t number_of_rows, uint32_t* selection, size_t& number_of_selected);
+    /// Call the function as a predicate for a batch of rows stored column-wise, see `Select`.
+    /// @return True for success, false for failure (compilation error or more than 2^32 rows).
+    bool SelectColumns(const int64_t* const* columns, size_t number_of_rows, uint32_t* selection, size_t& number_of_selected, const std::vector<bool>* scalar_parameters = nullptr);
+    /// Call the function on the JIT's executor, so the calling thread neither waits for the compilation of the first call nor for the evaluation.
+    /// @return The future of the return value, see `Call`.
+    std::future<std::optional<int64_t>> CallAsync(std::vector<int64_t> arguments);
+    /// Call the function on the JIT's executor and pass the return value to `callback`, which runs on the executor's thread.
+    void CallAsync(std::vector<int64_t> arguments, std::function<void(std::optional<int64_t>)> callback);
+    /// Compile the function on the JIT's executor, e.g. ahead of the first call.
+    /// @return The future of the success, false for a compilation error.
+    std::future<bool> CompileAsync();
     /// Call operator the call the function handle.
     template<typename... Parameters>
     std::optional<int64_t> operator()(Parameters... parameters) {
-        {
-            /// Check.
-            std::scoped_lock lock_reg(jit->register_mutex);
-            std::scoped_lock lock_fun(*jit->mutexes[index]);
-            if (!jit->flags[index]) {
-                if (this->Compile() != 0) {
-                    return {};
-                }
-                jit->flags[index] = true;
-            }
-        }
-
-        /// Set parameter's values.
-        std::vector<unsigned> parameter_vector = {static_cast<unsigned>(parameters)...};
-        EvaluationContext ec = *jit->ecs[index];
-        size_t next_argument_index = 0;
-        for (auto& entry : ec.GetValueTable()) {
-            if (entry.second.GetType() == Symbol::Type::PARAMETER) {
-                entry.second.SetValue(parameter_vector[next_argument_index++]);
-            }
-        }
-
-        /// Run the function.
-        const int64_t return_value = jit->asts[index]->Evaluate(ec);
-        if (ec.GetDivisionByZero()) {
-            std::cerr << "Division by zero error" << std::endl;
-            return {};
-        }
-        return {return_value};
+        const std::array<int64_t, sizeof...(Parameters)> arguments = {static_cast<int64_t>(parameters)...};
+        return Call(arguments.data(), arguments.size());
     }
 };
 //---------------------------------------------------------------------------
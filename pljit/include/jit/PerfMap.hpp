@@ -0,0 +1,60 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <string_view>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Names generated code for Linux `perf`, so profiles attribute the samples to the PL/0 functions instead of anonymous addresses.
+class PerfMap {
+    public:
+    /// The output format.
+    enum class Format {
+        /// `/tmp/perf-<pid>.map`: one `START SIZE name` line per function, read by `perf report`.
+        Map,
+        /// `jit-<pid>.dump`: jitdump records including the code bytes, merged by `perf inject --jit`.
+        JitDump,
+    };
+
+    /// Constructor, opens the file at its default location.
+    explicit PerfMap(Format format);
+    /// Constructor, opens the file at `path`.
+    PerfMap(Format format, std::string path);
+    /// Destructor.
+    ~PerfMap();
+    PerfMap(const PerfMap&) = delete;
+    PerfMap& operator=(const PerfMap&) = delete;
+
+    /// Get the default path of the format for this process.
+    static std::string GetDefaultPath(Format format);
+    /// If the file could be opened.
+    [[nodiscard]] bool IsOpen() const;
+    /// Get the path of the file.
+    [[nodiscard]] const std::string& GetPath() const;
+    /// Record the code of a function. The code has to be readable for jitdump, which copies it.
+    void Register(const void* code, size_t size, std::string_view name);
+
+    private:
+    /// The mutex.
+    std::mutex mutex;
+    /// The format.
+    const Format format;
+    /// The path.
+    const std::string path;
+    /// The file, nullptr if it could not be opened.
+    FILE* file = nullptr;
+    /// The marker mapping of a jitdump file, which tells `perf record` where to find it.
+    void* marker = nullptr;
+    /// The index of the next jitdump code record.
+    uint64_t code_index = 0;
+
+    /// Write the jitdump file header.
+    void WriteJitDumpHeader();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
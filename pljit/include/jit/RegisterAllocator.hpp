@@ -0,0 +1,60 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "jit/IR.hpp"
+#include <cstdint>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A linear scan register allocator (Poletto and Sarkar) over the straight-line instructions of the IR.
+/// It maps each virtual register to one of `number_of_registers` machine registers or to a spill slot in the frame.
+/// The allocator only knows the number of registers, so each backend maps the indices to its own register set.
+class LinearScanRegisterAllocator {
+    public:
+    /// The location of a virtual register.
+    struct Location {
+        /// The kinds of location.
+        enum class Kind : uint8_t {
+            /// A machine register.
+            Register,
+            /// A spill slot in the frame.
+            Spill
+        };
+        /// The kind of location.
+        Kind kind = Kind::Register;
+        /// The index of the machine register or the spill slot.
+        uint32_t index = 0;
+    };
+    /// The live interval of a virtual register: from its definition to its last use, as instruction indices.
+    struct Interval {
+        /// The instruction defining the register.
+        uint32_t start;
+        /// The last instruction using the register.
+        uint32_t end;
+    };
+    /// The result of the allocation.
+    struct Allocation {
+        /// The location of each virtual register.
+        std::vector<Location> locations;
+        /// The number of spill slots needed in the frame.
+        uint32_t number_of_spill_slots = 0;
+        /// The number of machine registers used.
+        uint32_t number_of_used_registers = 0;
+    };
+
+    /// Constructor.
+    explicit LinearScanRegisterAllocator(uint32_t number_of_registers);
+    /// Compute the live intervals of the virtual registers.
+    static std::vector<Interval> ComputeLiveIntervals(const IRFunction& function);
+    /// Allocate the virtual registers of the function.
+    /// An instruction may define its register in the location of an operand it uses for the last time,
+    /// so backends read all operands before writing the destination.
+    [[nodiscard]] Allocation Allocate(const IRFunction& function) const;
+
+    private:
+    /// The number of machine registers.
+    const uint32_t number_of_registers;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
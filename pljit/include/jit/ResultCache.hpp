@@ -0,0 +1,95 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A bounded, lock-striped cache: arguments -> result of a function.
+/// PL/0 functions have no side effects and only depend on their parameters, so their results (including the division by zero error) can be cached.
+/// The cache turns itself off, when its hit rate is too low to pay for the lookups.
+class ResultCache {
+    public:
+    /// The hit and miss counters.
+    struct Statistics {
+        /// The number of lookups answered by the cache.
+        uint64_t hits = 0;
+        /// The number of lookups not answered by the cache.
+        uint64_t misses = 0;
+        /// If the cache is still enabled.
+        bool enabled = false;
+    };
+    /// The default number of cached results.
+    static constexpr size_t default_capacity = 4096;
+    /// The number of lookups after which the hit rate is checked.
+    static constexpr uint64_t window_size = 4096;
+    /// The minimum hit rate in percent over a window to keep the cache enabled.
+    static constexpr uint64_t min_hit_rate_percent = 10;
+
+    /// Constructor.
+    ResultCache(size_t number_of_arguments, size_t capacity);
+    /// Look up the result for the arguments.
+    /// @return True if the result is cached, then it is written to `result`.
+    bool Lookup(const int64_t* arguments, std::optional<int64_t>& result);
+    /// Insert the result for the arguments, possibly evicting another one.
+    void Insert(const int64_t* arguments, std::optional<int64_t> result);
+    /// If the cache is enabled.
+    [[nodiscard]] bool IsEnabled() const;
+    /// Get the hit and miss counters.
+    [[nodiscard]] Statistics GetStatistics() const;
+    /// Get the number of bytes retained by the cache.
+    [[nodiscard]] size_t GetMemoryUsage() const;
+
+    private:
+    /// The number of stripes, each one protected by its own mutex.
+    static constexpr size_t number_of_stripes = 16;
+    /// The number of slots probed for a lookup.
+    static constexpr size_t number_of_probes = 4;
+    /// A cached result.
+    struct Slot {
+        /// The hash of the arguments, 0 for an empty slot.
+        uint64_t hash = 0;
+        /// The result.
+        std::optional<int64_t> result;
+    };
+    /// A stripe of the cache.
+    struct alignas(64) Stripe {
+        /// The mutex of the stripe.
+        std::mutex mutex;
+        /// The slots.
+        std::vector<Slot> slots;
+        /// The arguments of the slots, `number_of_arguments` per slot.
+        std::vector<int64_t> arguments;
+    };
+
+    /// The number of arguments of the function.
+    const size_t number_of_arguments;
+    /// The number of slots per stripe.
+    const size_t slots_per_stripe;
+    /// The stripes.
+    std::array<Stripe, number_of_stripes> stripes;
+    /// If the cache is enabled.
+    std::atomic<bool> enabled = true;
+    /// The hit counter.
+    std::atomic<uint64_t> hits = 0;
+    /// The miss counter.
+    std::atomic<uint64_t> misses = 0;
+    /// The lookups in the current window.
+    std::atomic<uint64_t> window_lookups = 0;
+    /// The hits in the current window.
+    std::atomic<uint64_t> window_hits = 0;
+
+    /// Hash the arguments. Never 0, which marks an empty slot.
+    [[nodiscard]] uint64_t Hash(const int64_t* arguments) const;
+    /// Check if the slot holds the arguments.
+    [[nodiscard]] bool Matches(const Stripe& stripe, size_t slot, uint64_t hash, const int64_t* arguments) const;
+    /// Account a lookup and disable the cache, if the hit rate of the window is too low.
+    void Account(bool hit);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
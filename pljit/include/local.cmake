@@ -4,9 +4,17 @@
 
 set(
         PLJIT_INCLUDES
+        include/util/AllocationTracker.hpp
+        include/util/MemoryUsage.hpp
+        include/util/MappedFile.hpp
+        include/util/Executor.hpp
+        include/util/ThreadPool.hpp
         include/util/SourceCodeManagement.hpp
         include/util/SourceCodeReference.hpp
         include/util/Defer.hpp
+        include/util/InstrumentedMutex.hpp
+        include/util/Trace.hpp
+        include/util/WorkloadGenerator.hpp
         include/lexer/Token.hpp
         include/lexer/Lexer.hpp
         include/parser/ParseTreeNode.hpp
@@ -21,5 +29,21 @@ set(
         include/optimization/OptimizationPass.hpp
         include/optimization/DeadCodeElimination.hpp
         include/optimization/ConstantPropagation.hpp
+        include/optimization/DeadStoreElimination.hpp
+        include/optimization/ParameterBinding.hpp
+        include/optimization/PassManager.hpp
+        include/jit/ArrowCDataInterface.hpp
+        include/jit/ArrowEvaluator.hpp
+        include/jit/BatchServer.hpp
+        include/jit/CodeMemory.hpp
+        include/jit/CallAwaitable.hpp
+        include/jit/ColumnEvaluator.hpp
+        include/jit/FunctionPipeline.hpp
+        include/jit/FunctionStatistics.hpp
+        include/jit/FusedKernel.hpp
+        include/jit/IR.hpp
+        include/jit/PerfMap.hpp
+        include/jit/RegisterAllocator.hpp
+        include/jit/ResultCache.hpp
         include/jit/JIT.hpp
 )
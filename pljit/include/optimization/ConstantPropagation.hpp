@@ -22,6 +22,9 @@ class ConstantPropagation : public OptimizationPass {
     /// A optional for return value.
     std::optional<int64_t> return_value = std::nullopt;
 
+    /// Replace the constant sub-expressions of a non-constant expression with literals.
+    void FoldConstantChildren(ASTNode& node);
+
     /// Optimization Pass (constant propagation) Visit methods for the IdentifierPrimaryExpressionAST.
     void Visit(IdentifierPrimaryExpressionAST& node) override;
     /// Optimization Pass (constant propagation) Visit methods for the LiteralPrimaryExpressionAST.
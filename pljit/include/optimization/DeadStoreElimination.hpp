@@ -0,0 +1,43 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "optimization/OptimizationPass.hpp"
+#include <string_view>
+#include <unordered_set>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A visitor does optimization: dead store elimination.
+/// An assignment is removed, if its value is never read before the "RETURN" or the next assignment of the same identifier,
+/// and its expression cannot fail with a division by zero error.
+/// Running it after the constant propagation removes the assignments of folded constants.
+class DeadStoreElimination : public OptimizationPass {
+    public:
+    /// Constructor.
+    DeadStoreElimination() = default;
+    /// The public interface of the Optimization Pass: dead store elimination.
+    void Optimize(FunctionAST& node) override;
+
+    private:
+    /// The identifiers read by the visited expression.
+    std::unordered_set<std::string_view> reads;
+    /// If the visited expression contains a division.
+    bool division = false;
+
+    /// Optimization Pass (dead store elimination) Visit methods for the IdentifierPrimaryExpressionAST.
+    void Visit(IdentifierPrimaryExpressionAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the LiteralPrimaryExpressionAST.
+    void Visit(LiteralPrimaryExpressionAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the UnaryExpressionAST.
+    void Visit(UnaryExpressionAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the BinaryExpressionAST.
+    void Visit(BinaryExpressionAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the AssignmentStatementAST.
+    void Visit(AssignmentStatementAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the ReturnStatementAST.
+    void Visit(ReturnStatementAST& node) override;
+    /// Optimization Pass (dead store elimination) Visit methods for the FunctionAST.
+    void Visit(FunctionAST& node) override;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -25,6 +25,8 @@ class EvaluationContext {
     /// Get the value table.
     using ValueTable = SymbolTable;
     ValueTable& GetValueTable();
+    /// Get the number of bytes retained by the context.
+    [[nodiscard]] size_t GetMemoryUsage() const;
 
     private:
     /// If we have division by zero error.
@@ -10,6 +10,12 @@ class OptimizationPass : public ASTNodeVisitor {
     public:
     /// The public interface of the Optimization Pass.
     virtual void Optimize(FunctionAST&) = 0;
+    /// If the optimization changed the AST, which is needed to run passes until a fixed point.
+    [[nodiscard]] bool HasChanged() const { return changed; }
+
+    protected:
+    /// If the optimization changed the AST.
+    bool changed = false;
 };
 //---------------------------------------------------------------------------
 } // namespace pljit
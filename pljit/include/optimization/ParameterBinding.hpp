@@ -0,0 +1,32 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "ast/ASTNode.hpp"
+#include "ast/SymbolTable.hpp"
+#include <string>
+#include <unordered_map>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Binds a subset of the parameters to fixed values for the specialization of a function.
+/// Each bound parameter turns into a variable, which is assigned its value in front of all statements.
+/// The constant propagation afterwards folds the bound values into the body.
+class ParameterBinding {
+    public:
+    /// The bound values: parameter name -> value.
+    using Bindings = std::unordered_map<std::string, int64_t>;
+    /// Constructor.
+    ParameterBinding(SymbolTable& symbol_table, const Bindings& bindings);
+    /// Bind the parameters in the AST and remove them from the parameters' names.
+    /// @return True for success, false for failure (binding an identifier which is not a parameter).
+    bool Bind(FunctionAST& node, std::vector<std::string_view>& parameters);
+
+    private:
+    /// The symbol table of the function to be specialized.
+    SymbolTable& symbol_table;
+    /// The bound values.
+    const Bindings& bindings;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
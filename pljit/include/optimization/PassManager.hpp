@@ -0,0 +1,66 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include "ast/SymbolTable.hpp"
+#include "optimization/OptimizationPass.hpp"
+#include "util/Trace.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// The optimization levels, each one is a pipeline of the pass manager.
+enum class OptimizationLevel {
+    /// No optimization.
+    O0,
+    /// Dead code elimination.
+    O1,
+    /// Dead code elimination and constant propagation.
+    O2,
+    /// Dead code elimination, constant propagation and dead store elimination until a fixed point.
+    O3
+};
+//---------------------------------------------------------------------------
+/// The pass manager runs named pipelines of optimization passes on an AST.
+class PassManager {
+    public:
+    /// A factory creating a fresh pass for the symbol table of the function, as the passes keep state.
+    using PassFactory = std::function<std::unique_ptr<OptimizationPass>(const SymbolTable&)>;
+    /// The default maximum number of iterations until a fixed point.
+    static constexpr size_t default_max_iterations = 8;
+
+    /// Constructor: registers the passes "dead-code-elimination", "constant-propagation", "dead-store-elimination"
+    /// and the pipelines of the optimization levels.
+    PassManager();
+    /// Register a pass.
+    void AddPass(std::string name, PassFactory factory);
+    /// Register a pipeline of registered passes, which is run until no pass changes the AST, but at most `max_iterations` times.
+    /// @return True for success, false for failure (unknown pass).
+    bool AddPipeline(std::string name, std::vector<std::string> passes, size_t max_iterations = 1);
+    /// Check if the pipeline is registered.
+    [[nodiscard]] bool HasPipeline(std::string_view name) const;
+    /// Run a pipeline on the AST. With a trace recorder, every pass run is recorded as a span of the function.
+    /// @return The number of iterations run.
+    size_t Run(std::string_view pipeline, FunctionAST& node, const SymbolTable& symbol_table, TraceRecorder* trace_recorder = nullptr, std::string_view function = {}) const;
+    /// Get the pipeline's name of an optimization level.
+    static std::string_view GetPipelineName(OptimizationLevel level);
+
+    private:
+    /// A pipeline.
+    struct Pipeline {
+        /// The passes' names.
+        std::vector<std::string> passes;
+        /// The maximum number of iterations.
+        size_t max_iterations;
+    };
+    /// The registered passes.
+    std::unordered_map<std::string, PassFactory> passes;
+    /// The registered pipelines.
+    std::unordered_map<std::string, Pipeline> pipelines;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
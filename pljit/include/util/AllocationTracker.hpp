@@ -0,0 +1,48 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstdint>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Counts the heap allocations of the calling thread.
+/// Only available when built with `PLJIT_TRACK_ALLOCATIONS`, which replaces the global `operator new` and `operator delete`.
+/// Otherwise all counters are 0.
+class AllocationTracker {
+    public:
+    /// The allocations of a scope.
+    struct Statistics {
+        /// The number of allocations.
+        uint64_t allocations = 0;
+        /// The number of allocated bytes.
+        uint64_t allocated_bytes = 0;
+        /// The peak of the bytes allocated and not freed yet since the scope began.
+        uint64_t peak_bytes = 0;
+    };
+
+    /// Counts the allocations of the calling thread while it is alive. Scopes can be nested.
+    class Scope {
+        public:
+        /// Constructor, begins counting.
+        Scope();
+        /// Destructor.
+        ~Scope();
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        /// Get the allocations since the scope began.
+        [[nodiscard]] Statistics GetStatistics() const;
+
+        private:
+        /// The thread's counters when the scope began.
+        int64_t begin_bytes;
+        uint64_t begin_allocations;
+        uint64_t begin_allocated_bytes;
+        /// The thread's peak of the enclosing scope.
+        int64_t outer_peak_bytes;
+    };
+
+    /// If the allocations are tracked.
+    static bool IsEnabled();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
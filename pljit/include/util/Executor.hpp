@@ -0,0 +1,46 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Runs submitted jobs on a fixed set of threads in submission order, so the submitting thread does not wait for them.
+class Executor {
+    public:
+    /// A job.
+    using Job = std::function<void()>;
+
+    /// Constructor. 0 threads for the number of hardware threads.
+    explicit Executor(size_t threads = 0);
+    /// Destructor. Runs the remaining jobs, before the threads are joined.
+    ~Executor();
+    /// Get the number of threads.
+    [[nodiscard]] size_t GetNumberOfThreads() const;
+    /// Add a job, which runs on one of the threads.
+    void Submit(Job job);
+    /// If the calling thread is one of the threads, which the destructor cannot join.
+    [[nodiscard]] bool IsWorkerThread() const;
+
+    private:
+    /// The mutex.
+    std::mutex mutex;
+    /// Signals a new job or the shutdown.
+    std::condition_variable condition;
+    /// The jobs, which are not started.
+    std::deque<Job> jobs;
+    /// If the threads stop, once the jobs are done.
+    bool stopping = false;
+    /// The threads.
+    std::vector<std::thread> threads;
+
+    /// The loop of a thread.
+    void WorkerLoop();
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,47 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A mutex counting its acquisitions and the time threads waited for it.
+/// An uncontended lock costs a `try_lock` and a counter increment, the clock is only read when the lock has to wait.
+class InstrumentedMutex {
+    public:
+    /// The counters.
+    struct Statistics {
+        /// The number of acquisitions.
+        uint64_t acquisitions = 0;
+        /// The number of acquisitions which had to wait.
+        uint64_t contentions = 0;
+        /// The cumulative waiting time in nanoseconds.
+        uint64_t wait_ns = 0;
+
+        /// Add the counters of another mutex.
+        Statistics& operator+=(const Statistics& other);
+    };
+
+    /// Lock the mutex.
+    void lock();
+    /// Try to lock the mutex.
+    bool try_lock();
+    /// Unlock the mutex.
+    void unlock() { mutex.unlock(); }
+    /// Get the counters.
+    [[nodiscard]] Statistics GetStatistics() const;
+
+    private:
+    /// The mutex.
+    std::mutex mutex;
+    /// The number of acquisitions.
+    std::atomic<uint64_t> acquisitions = 0;
+    /// The number of acquisitions which had to wait.
+    std::atomic<uint64_t> contentions = 0;
+    /// The cumulative waiting time in nanoseconds.
+    std::atomic<uint64_t> wait_ns = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
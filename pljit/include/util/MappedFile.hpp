@@ -0,0 +1,44 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <string>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A memory-mapped file, which is read or written without copying it through a buffer.
+class MappedFile {
+    public:
+    /// Constructor.
+    MappedFile() = default;
+    /// Destructor, unmaps the file.
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    /// Move constructor.
+    MappedFile(MappedFile&& other) noexcept;
+    /// Move assignment.
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /// Map an existing file for reading. The pages are advised for sequential access.
+    /// @return True for success, false for failure.
+    bool OpenRead(const std::string& path);
+    /// Create (or truncate) a file of `size` bytes and map it for writing.
+    /// @return True for success, false for failure.
+    bool Create(const std::string& path, size_t size);
+    /// Unmap the file. The written pages are flushed to the file by the kernel.
+    void Close();
+    /// Get the mapped bytes, nullptr for an empty or closed file.
+    [[nodiscard]] uint8_t* GetData() const;
+    /// Get the size in bytes.
+    [[nodiscard]] size_t GetSize() const;
+
+    private:
+    /// The mapped bytes.
+    uint8_t* data = nullptr;
+    /// The size in bytes.
+    size_t size = 0;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,33 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstddef>
+#include <string>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Estimates of the heap memory owned by the standard containers, without the memory owned by their elements.
+/// They follow the layout of libstdc++ and ignore the allocator's overhead.
+namespace memory_usage {
+//---------------------------------------------------------------------------
+/// The heap memory of a string, 0 for short strings stored inline.
+inline size_t Of(const std::string& string) {
+    return string.capacity() > 15 ? string.capacity() + 1 : 0;
+}
+//---------------------------------------------------------------------------
+/// The heap memory of a vector.
+template <typename T>
+size_t Of(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+//---------------------------------------------------------------------------
+/// The heap memory of an unordered map or set: the buckets and a node per element with the next pointer and the cached hash.
+template <typename HashTable>
+size_t OfHashTable(const HashTable& table) {
+    return table.bucket_count() * sizeof(void*) + table.size() * (sizeof(void*) + sizeof(typename HashTable::value_type) + sizeof(size_t));
+}
+//---------------------------------------------------------------------------
+} // namespace memory_usage
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -21,6 +21,8 @@ class SourceCodeManagement {
     [[nodiscard]] size_t GetNumberOfLines() const;
     /// Get the length of a line.
     [[nodiscard]] size_t GetLineLength(size_t line_number) const;
+    /// Get the number of bytes retained by the code.
+    [[nodiscard]] size_t GetMemoryUsage() const;
 
     private:
     /// Lines of code in vector.
@@ -0,0 +1,90 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A work-stealing thread pool running the tasks of a parallel loop.
+/// Every thread starts with a contiguous range of the tasks and takes them from its front. A thread without tasks
+/// steals the back half of the remaining range of another thread, so the threads stay balanced with uneven task costs.
+class ThreadPool {
+    public:
+    /// The counters.
+    struct Statistics {
+        /// The number of parallel loops.
+        uint64_t loops = 0;
+        /// The number of tasks.
+        uint64_t tasks = 0;
+        /// The number of ranges stolen from other threads.
+        uint64_t steals = 0;
+    };
+    /// A task of a loop, given its index and the index of the thread running it.
+    using Task = std::function<void(size_t task, size_t thread)>;
+
+    /// Constructor. The calling thread of a loop is one of `threads` threads, 0 for the number of hardware threads.
+    explicit ThreadPool(size_t threads = 0);
+    /// Destructor.
+    ~ThreadPool();
+    /// Get the number of threads including the calling thread.
+    [[nodiscard]] size_t GetNumberOfThreads() const;
+    /// Run the tasks 0 to `number_of_tasks - 1` on the threads and wait for them.
+    /// The calling thread runs tasks, too. If another loop is running, e.g. a nested one, the calling thread runs all tasks alone.
+    void ParallelFor(size_t number_of_tasks, const Task& task);
+    /// Get the counters.
+    [[nodiscard]] Statistics GetStatistics() const;
+
+    private:
+    /// The remaining tasks of a thread, aligned to separate the cache lines of the threads.
+    struct alignas(64) Range {
+        /// The mutex.
+        std::mutex mutex;
+        /// The first remaining task.
+        size_t begin = 0;
+        /// The end of the remaining tasks.
+        size_t end = 0;
+    };
+
+    /// The ranges, one per thread.
+    std::unique_ptr<Range[]> ranges;
+    /// The number of threads including the calling thread.
+    size_t number_of_threads;
+    /// The worker threads.
+    std::vector<std::thread> workers;
+    /// Protects the loop state and signals a new loop.
+    std::mutex mutex;
+    /// Signals a new loop or the shutdown.
+    std::condition_variable condition;
+    /// Held by the running loop.
+    std::mutex loop_mutex;
+    /// The number of the current loop.
+    uint64_t generation = 0;
+    /// If a loop is running.
+    bool running = false;
+    /// If the workers stop.
+    bool stopping = false;
+    /// The task of the current loop.
+    const Task* current_task = nullptr;
+    /// The number of tasks of the current loop, which are not done.
+    std::atomic<size_t> remaining_tasks = 0;
+    /// The number of workers in the current loop.
+    std::atomic<size_t> active_workers = 0;
+    /// The counters.
+    std::atomic<uint64_t> loops = 0;
+    std::atomic<uint64_t> tasks = 0;
+    std::atomic<uint64_t> steals = 0;
+
+    /// The loop of a worker thread.
+    void WorkerLoop(size_t thread);
+    /// Run tasks of the current loop, until none are left to take or steal.
+    void Work(size_t thread, const Task& task);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,86 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Records timed spans of the threads and writes them in the Chrome trace event format,
+/// which can be opened with `chrome://tracing` or Perfetto.
+class TraceRecorder {
+    public:
+    /// A complete event ("ph":"X").
+    struct Event {
+        /// The name.
+        std::string name;
+        /// The category.
+        std::string category;
+        /// The name of the function, empty if none.
+        std::string function;
+        /// The begin in nanoseconds since the recorder was created.
+        uint64_t begin_ns;
+        /// The duration in nanoseconds.
+        uint64_t duration_ns;
+        /// The id of the recording thread.
+        uint32_t thread_id;
+    };
+    /// The default maximum number of events.
+    static constexpr size_t default_max_events = size_t(1) << 20;
+
+    /// Constructor. Events beyond `max_events` are dropped, so a long running process does not run out of memory.
+    explicit TraceRecorder(size_t max_events = default_max_events);
+    /// Record a span.
+    void Record(std::string_view name, std::string_view category, std::string_view function, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+    /// Get a copy of the recorded events.
+    [[nodiscard]] std::vector<Event> GetEvents() const;
+    /// Get the number of dropped events.
+    [[nodiscard]] size_t GetDroppedEvents() const;
+    /// Write the events as trace event JSON.
+    void Write(std::ostream& out) const;
+    /// Write the events as trace event JSON to a file.
+    /// @return True for success, false for failure.
+    bool WriteFile(const std::string& path) const;
+
+    private:
+    /// The mutex.
+    mutable std::mutex mutex;
+    /// The maximum number of events.
+    const size_t max_events;
+    /// The time the recorder was created.
+    const std::chrono::steady_clock::time_point start;
+    /// The events.
+    std::vector<Event> events;
+    /// The number of dropped events.
+    size_t dropped_events = 0;
+};
+//---------------------------------------------------------------------------
+/// A span recorded when it goes out of scope. Does nothing without a recorder.
+class TraceSpan {
+    public:
+    /// Constructor.
+    TraceSpan(TraceRecorder* recorder, std::string_view name, std::string_view category, std::string_view function = {});
+    /// Destructor, records the span.
+    ~TraceSpan();
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    private:
+    /// The recorder, nullptr if tracing is disabled.
+    TraceRecorder* recorder;
+    /// The name.
+    std::string_view name;
+    /// The category.
+    std::string_view category;
+    /// The name of the function.
+    std::string_view function;
+    /// The begin.
+    std::chrono::steady_clock::time_point begin;
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
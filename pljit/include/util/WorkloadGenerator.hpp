@@ -0,0 +1,79 @@
+#pragma once
+//---------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <string>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// A generator of random, valid PL/0 functions for stress tests and benchmarks.
+/// The same seed and options always generate the same functions.
+class WorkloadGenerator {
+    public:
+    /// The shape of the generated functions.
+    struct Options {
+        /// The number of parameters.
+        size_t number_of_parameters = 3;
+        /// The number of variables.
+        size_t number_of_variables = 3;
+        /// The number of constants.
+        size_t number_of_constants = 2;
+        /// The number of assignments before the final RETURN.
+        size_t number_of_statements = 10;
+        /// The maximum depth of an expression tree, 0 for single operands.
+        size_t max_expression_depth = 3;
+        /// The relative weights of `+`, `-` and `*` among the binary operators other than `/`.
+        uint32_t add_weight = 4;
+        uint32_t sub_weight = 3;
+        uint32_t mul_weight = 2;
+        /// The probability in percent of a binary operator to be `/`.
+        uint32_t division_percent = 10;
+        /// Divide only by non-zero literals, so the functions never fail with a division by zero.
+        bool nonzero_divisors = false;
+        /// The probability in percent of an operand to be a literal or a constant instead of a parameter or variable.
+        uint32_t constant_density_percent = 30;
+        /// The probability in percent of an operand to be negated.
+        uint32_t negation_percent = 10;
+        /// The maximum value of a literal or constant.
+        int64_t max_literal = 100;
+    };
+
+    /// Constructor with the default options.
+    explicit WorkloadGenerator(uint64_t seed);
+    /// Constructor.
+    WorkloadGenerator(uint64_t seed, Options options);
+    /// Generate the next function.
+    std::string Generate();
+    /// Get the options.
+    [[nodiscard]] const Options& GetOptions() const { return options; }
+
+    private:
+    /// The options.
+    const Options options;
+    /// The state of the random number generator.
+    uint64_t state;
+    /// The number of initialized variables, which are the first ones.
+    size_t initialized_variables = 0;
+    /// The generated function.
+    std::string code;
+
+    /// Get the next random number (SplitMix64, which is identical on all platforms unlike the standard distributions).
+    uint64_t Next();
+    /// Get a random number in [0, n).
+    uint64_t Uniform(uint64_t n);
+    /// Get true with the probability in percent.
+    bool Percent(uint32_t percent);
+    /// Append the name of an identifier: the prefix and the index in letters, as identifiers must not contain digits.
+    void AppendName(char prefix, size_t index);
+    /// Append a literal.
+    void AppendLiteral(int64_t min);
+    /// Append a single operand.
+    void AppendOperand();
+    /// Append an expression of at most `depth` levels of binary operators.
+    void AppendExpression(size_t depth);
+    /// Append a declaration list.
+    void AppendDeclarations(const char* keyword, char prefix, size_t count, bool constants);
+};
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,158 @@
+//---------------------------------------------------------------------------
+#include "jit/ArrowEvaluator.hpp"
+#include <cstring>
+#include <iostream>
+#include <memory>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The buffers of an exported result array.
+struct ResultData {
+    /// The values.
+    std::unique_ptr<int64_t[]> values;
+    /// The validity bitmap, empty without nulls.
+    std::vector<uint8_t> validity;
+    /// The buffer pointers of the array.
+    const void* buffers[2] = {nullptr, nullptr};
+};
+//---------------------------------------------------------------------------
+/// Release an exported result array.
+void ReleaseArray(ArrowArray* array) {
+    delete static_cast<ResultData*>(array->private_data);
+    array->private_data = nullptr;
+    array->release = nullptr;
+}
+//---------------------------------------------------------------------------
+/// Release an exported result schema, whose strings are static.
+void ReleaseSchema(ArrowSchema* schema) {
+    schema->release = nullptr;
+}
+//---------------------------------------------------------------------------
+/// Get a bit of a bitmap.
+bool GetBit(const uint8_t* bitmap, int64_t index) {
+    return (bitmap[index >> 3] >> (index & 7)) & 1;
+}
+//---------------------------------------------------------------------------
+/// Clear the bits of `validity` for the rows, which are null in the bitmap starting at bit `offset`.
+void AndValidity(uint8_t* validity, const uint8_t* bitmap, int64_t offset, int64_t length) {
+    if (offset % 8 == 0) {
+        // Byte-aligned: the bits of eight rows at once.
+        const uint8_t* bytes = bitmap + offset / 8;
+        for (int64_t i = 0; i < (length + 7) / 8; i++) {
+            validity[i] &= bytes[i];
+        }
+        return;
+    }
+    for (int64_t i = 0; i < length; i++) {
+        if (!GetBit(bitmap, offset + i)) {
+            validity[i >> 3] &= static_cast<uint8_t>(~(1u << (i & 7)));
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+ArrowEvaluator::ArrowEvaluator(FunctionHandle function) : ArrowEvaluator(function, ColumnEvaluator::Options()) {}
+//---------------------------------------------------------------------------
+ArrowEvaluator::ArrowEvaluator(FunctionHandle function, ColumnEvaluator::Options options) : evaluator(function, options) {}
+//---------------------------------------------------------------------------
+const ColumnEvaluator::Statistics& ArrowEvaluator::GetStatistics() const { return evaluator.GetStatistics(); }
+//---------------------------------------------------------------------------
+bool ArrowEvaluator::Evaluate(const std::vector<const ArrowSchema*>& schemas, const std::vector<const ArrowArray*>& arrays, ArrowSchema* result_schema, ArrowArray* result) {
+    if (arrays.empty()) {
+        std::cerr << "The number of rows is unknown without a column" << std::endl;
+        return false;
+    }
+    return Evaluate(schemas, arrays, arrays.front()->length, nullptr, 0, result_schema, result);
+}
+//---------------------------------------------------------------------------
+bool ArrowEvaluator::EvaluateRecordBatch(const ArrowSchema& schema, const ArrowArray& batch, ArrowSchema* result_schema, ArrowArray* result) {
+    if (strcmp(schema.format, "+s") != 0 || schema.n_children != batch.n_children) {
+        std::cerr << "The record batch is not a struct array" << std::endl;
+        return false;
+    }
+    std::vector<const ArrowSchema*> schemas(schema.children, schema.children + schema.n_children);
+    std::vector<const ArrowArray*> arrays(batch.children, batch.children + batch.n_children);
+    // The struct's offset applies to its children, and its nulls are nulls of all children.
+    const auto* validity = batch.null_count != 0 && batch.n_buffers > 0 ? static_cast<const uint8_t*>(batch.buffers[0]) : nullptr;
+    return Evaluate(schemas, arrays, batch.length, validity, batch.offset, result_schema, result);
+}
+//---------------------------------------------------------------------------
+bool ArrowEvaluator::Evaluate(const std::vector<const ArrowSchema*>& schemas, const std::vector<const ArrowArray*>& arrays, int64_t length, const uint8_t* batch_validity, int64_t batch_offset,
+                              ArrowSchema* result_schema, ArrowArray* result) {
+    if (schemas.size() != arrays.size()) {
+        std::cerr << "The numbers of schemas and arrays differ" << std::endl;
+        return false;
+    }
+    std::vector<const int64_t*> columns;
+    for (size_t c = 0; c < arrays.size(); c++) {
+        const ArrowSchema& schema = *schemas[c];
+        const ArrowArray& array = *arrays[c];
+        if (strcmp(schema.format, "l") != 0 || schema.dictionary || array.n_buffers != 2) {
+            std::cerr << "Column " << c << " is not of type int64 but " << schema.format << std::endl;
+            return false;
+        }
+        if (!array.release || array.length < batch_offset + length) {
+            std::cerr << "Column " << c << " is released or has too few rows" << std::endl;
+            return false;
+        }
+        columns.push_back(static_cast<const int64_t*>(array.buffers[1]) + array.offset + batch_offset);
+    }
+
+    auto data = std::make_unique<ResultData>();
+    const auto rows = static_cast<size_t>(length);
+    data->values.reset(new int64_t[std::max<size_t>(rows, 1)]);
+    std::vector<uint8_t> errors(rows);
+    if (!evaluator.Evaluate(columns, rows, data->values.get(), errors.data())) {
+        return false;
+    }
+
+    // The validity: no division by zero, no null argument, and no null row of the record batch.
+    std::vector<uint8_t>& validity = data->validity;
+    validity.assign((rows + 7) / 8, 0);
+    for (size_t r = 0; r < rows; r++) {
+        validity[r >> 3] |= static_cast<uint8_t>(!errors[r] << (r & 7));
+    }
+    for (auto* array : arrays) {
+        if (array->null_count != 0 && array->buffers[0]) {
+            AndValidity(validity.data(), static_cast<const uint8_t*>(array->buffers[0]), array->offset + batch_offset, length);
+        }
+    }
+    if (batch_validity) {
+        AndValidity(validity.data(), batch_validity, batch_offset, length);
+    }
+    int64_t null_count = 0;
+    for (size_t r = 0; r < rows; r++) {
+        if (!GetBit(validity.data(), static_cast<int64_t>(r))) {
+            // The values of null arguments are undefined, so the results are zeroed.
+            data->values[r] = 0;
+            null_count++;
+        }
+    }
+    if (null_count == 0) {
+        validity = {};
+    }
+    data->buffers[0] = validity.empty() ? nullptr : validity.data();
+    data->buffers[1] = data->values.get();
+
+    *result = ArrowArray{};
+    result->length = length;
+    result->null_count = null_count;
+    result->offset = 0;
+    result->n_buffers = 2;
+    result->n_children = 0;
+    result->buffers = data->buffers;
+    result->release = ReleaseArray;
+    result->private_data = data.release();
+    *result_schema = ArrowSchema{};
+    result_schema->format = "l";
+    result_schema->name = "result";
+    result_schema->flags = ARROW_FLAG_NULLABLE;
+    result_schema->release = ReleaseSchema;
+    return true;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,323 @@
+//---------------------------------------------------------------------------
+#include "jit/BatchServer.hpp"
+#include "jit/FusedKernel.hpp"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The argument rows of a batch.
+struct Batch {
+    /// The arguments, row-major.
+    std::vector<int64_t> arguments;
+    /// The number of rows.
+    size_t rows = 0;
+};
+//---------------------------------------------------------------------------
+/// A queue of batches between the reader thread and the evaluating thread.
+class BatchChannel {
+    public:
+    /// Add a batch.
+    void Push(Batch* batch) {
+        {
+            std::scoped_lock lock(mutex);
+            batches.push_back(batch);
+        }
+        condition.notify_one();
+    }
+    /// Remove the oldest batch, waiting for one.
+    /// @return The batch, nullptr if the channel is closed and empty.
+    Batch* Pop() {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [&] { return !batches.empty() || closed; });
+        if (batches.empty()) {
+            return nullptr;
+        }
+        Batch* batch = batches.front();
+        batches.pop_front();
+        return batch;
+    }
+    /// Close the channel, the remaining batches can still be removed.
+    void Close() {
+        {
+            std::scoped_lock lock(mutex);
+            closed = true;
+        }
+        condition.notify_all();
+    }
+    /// Close the channel and drop the remaining batches.
+    void Cancel() {
+        {
+            std::scoped_lock lock(mutex);
+            batches.clear();
+            closed = true;
+        }
+        condition.notify_all();
+    }
+
+    private:
+    /// The mutex.
+    std::mutex mutex;
+    /// Signals a new batch or the closing.
+    std::condition_variable condition;
+    /// The batches.
+    std::deque<Batch*> batches;
+    /// If the channel is closed.
+    bool closed = false;
+};
+//---------------------------------------------------------------------------
+/// Parses the rows of the input.
+class RowReader {
+    public:
+    /// Constructor.
+    RowReader(std::istream& in, BatchServer::Format format, size_t number_of_parameters, size_t chunk_size)
+     : in(in), format(format), number_of_parameters(number_of_parameters), chunk_size(chunk_size) {}
+    /// Read up to `batch_size` rows.
+    /// @return True for success, false for failure (malformed input). The rows before the malformed one are read.
+    bool Read(Batch& batch, size_t batch_size) {
+        batch.arguments.resize(batch_size * number_of_parameters);
+        batch.rows = 0;
+        return format == BatchServer::Format::Text ? ReadText(batch, batch_size) : ReadBinary(batch, batch_size);
+    }
+    /// If the end of the input is reached.
+    [[nodiscard]] bool IsFinished() const { return finished; }
+    /// Get the message of the malformed input, empty without one.
+    [[nodiscard]] const std::string& GetError() const { return error; }
+
+    private:
+    /// The input.
+    std::istream& in;
+    /// The format.
+    BatchServer::Format format;
+    /// The number of integers per row.
+    size_t number_of_parameters;
+    /// The number of bytes read at once.
+    size_t chunk_size;
+    /// The buffered text.
+    std::string data;
+    /// The position of the next line in `data`.
+    size_t position = 0;
+    /// The number of the last parsed line.
+    size_t line_number = 0;
+    /// If the end of the input was read.
+    bool end_of_input = false;
+    /// If all rows were returned.
+    bool finished = false;
+    /// The message of the malformed input, reported after the results of the rows before it.
+    std::string error;
+
+    /// Read the next chunk of text, keeping the unparsed rest.
+    void Refill() {
+        data.erase(0, position);
+        position = 0;
+        const size_t size = data.size();
+        data.resize(size + chunk_size);
+        in.read(&data[size], static_cast<std::streamsize>(chunk_size));
+        const auto read = static_cast<size_t>(in.gcount());
+        data.resize(size + read);
+        end_of_input = read < chunk_size;
+    }
+    /// Check for a separator of the text format.
+    static bool IsSeparator(char c) { return c == ' ' || c == '\t' || c == ',' || c == '\r'; }
+    /// Parse a line into the arguments of a row.
+    /// @return True for success, false for failure (no integer, out of range, or a wrong number of integers).
+    bool ParseLine(const char* begin, const char* end, int64_t* row) const {
+        size_t count = 0;
+        while (true) {
+            while (begin != end && IsSeparator(*begin)) { ++begin; }
+            if (begin == end) { break; }
+            if (count == number_of_parameters) { return false; }
+            if (*begin == '+') { ++begin; }
+            auto [next, error] = std::from_chars(begin, end, row[count++]);
+            if (error != std::errc() || (next != end && !IsSeparator(*next))) { return false; }
+            begin = next;
+        }
+        return count == number_of_parameters;
+    }
+    /// Read the rows of the text format.
+    bool ReadText(Batch& batch, size_t batch_size) {
+        // The bytes of the current line already searched for the newline, so a line spanning several chunks is not searched again.
+        size_t searched = 0;
+        while (batch.rows < batch_size) {
+            size_t line_end = data.find('\n', position + searched);
+            if (line_end == std::string::npos) {
+                if (!end_of_input) {
+                    searched = data.size() - position;
+                    Refill();
+                    continue;
+                }
+                if (position == data.size()) {
+                    finished = true;
+                    break;
+                }
+                // The last line without a newline.
+                line_end = data.size();
+            }
+            const char* begin = data.data() + position;
+            const char* end = data.data() + line_end;
+            position = std::min(line_end + 1, data.size());
+            searched = 0;
+            line_number++;
+            bool blank = true;
+            for (const char* c = begin; c != end && blank; ++c) { blank = IsSeparator(*c); }
+            // An empty line is the row of a function without parameters.
+            if (blank && number_of_parameters > 0) { continue; }
+            if (!ParseLine(begin, end, &batch.arguments[batch.rows * number_of_parameters])) {
+                error = "Malformed row in line " + std::to_string(line_number) + ": expected " + std::to_string(number_of_parameters) + " integers";
+                return false;
+            }
+            batch.rows++;
+        }
+        return true;
+    }
+    /// Read the records of the binary format.
+    bool ReadBinary(Batch& batch, size_t batch_size) {
+        const size_t record_size = number_of_parameters * sizeof(int64_t);
+        in.read(reinterpret_cast<char*>(batch.arguments.data()), static_cast<std::streamsize>(batch_size * record_size));
+        const auto read = static_cast<size_t>(in.gcount());
+        batch.rows = read / record_size;
+        if (read % record_size != 0) {
+            error = "Truncated record at the end of the input";
+            return false;
+        }
+        finished = batch.rows < batch_size;
+        return true;
+    }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+BatchServer::BatchServer(std::vector<FunctionHandle> functions) : BatchServer(std::move(functions), Options()) {}
+//---------------------------------------------------------------------------
+BatchServer::BatchServer(std::vector<FunctionHandle> functions, Options options) : functions(std::move(functions)), options(options) {}
+//---------------------------------------------------------------------------
+const BatchServer::Statistics& BatchServer::GetStatistics() const { return statistics; }
+//---------------------------------------------------------------------------
+bool BatchServer::Serve(std::istream& in, std::ostream& out) {
+    statistics = Statistics();
+    if (functions.empty() || options.batch_size == 0 || options.chunk_size == 0) {
+        std::cerr << "Nothing to serve" << std::endl;
+        return false;
+    }
+    // The functions are evaluated in one pass, which loads the arguments once and shares the common computations.
+    FusedKernel kernel(functions);
+    const std::optional<size_t> number_of_parameters = kernel.GetNumberOfParameters();
+    if (!number_of_parameters) {
+        return false;
+    }
+    if (options.format == Format::Binary && (*number_of_parameters == 0 || functions.size() > max_binary_functions)) {
+        std::cerr << "The binary format needs parameters and at most " << max_binary_functions << " functions" << std::endl;
+        return false;
+    }
+
+    // Three batches: one is read, one is evaluated, and one is waiting in between.
+    std::array<Batch, 3> batches;
+    BatchChannel free_batches;
+    BatchChannel full_batches;
+    for (auto& batch : batches) {
+        free_batches.Push(&batch);
+    }
+    std::string read_error;
+    std::thread reader_thread([&]() {
+        RowReader reader(in, options.format, *number_of_parameters, options.chunk_size);
+        while (!reader.IsFinished()) {
+            Batch* batch = free_batches.Pop();
+            if (!batch) { break; }  // The evaluation stopped.
+            const bool success = reader.Read(*batch, options.batch_size);
+            // The rows before a malformed one are still evaluated.
+            if (batch->rows) {
+                full_batches.Push(batch);
+            }
+            if (!success) {
+                read_error = reader.GetError();
+                break;
+            }
+        }
+        full_batches.Close();
+    });
+
+    const size_t number_of_functions = functions.size();
+    std::vector<int64_t> results(number_of_functions * options.batch_size);
+    std::vector<uint8_t> errors(number_of_functions * options.batch_size);
+    std::vector<int64_t*> result_columns(number_of_functions);
+    std::vector<uint8_t*> error_columns(number_of_functions);
+    for (size_t f = 0; f < number_of_functions; f++) {
+        result_columns[f] = &results[f * options.batch_size];
+        error_columns[f] = &errors[f * options.batch_size];
+    }
+    std::string text;
+    std::vector<int64_t> records;
+    bool success = true;
+    while (Batch* batch = full_batches.Pop()) {
+        const size_t rows = batch->rows;
+        kernel.EvaluateBatch(batch->arguments.data(), rows, result_columns.data(), error_columns.data());
+        for (size_t f = 0; f < number_of_functions; f++) {
+            for (size_t r = 0; r < rows; r++) {
+                statistics.division_by_zero_errors += errors[f * options.batch_size + r];
+            }
+        }
+        // The arguments are not needed anymore, so the reader can refill the batch while the results are written.
+        free_batches.Push(batch);
+
+        if (options.format == Format::Text) {
+            char number[24];
+            for (size_t r = 0; r < rows; r++) {
+                for (size_t f = 0; f < number_of_functions; f++) {
+                    if (f) { text += ' '; }
+                    const size_t i = f * options.batch_size + r;
+                    if (errors[i]) {
+                        text += "error";
+                    } else {
+                        text.append(number, std::to_chars(number, number + sizeof(number), results[i]).ptr);
+                    }
+                }
+                text += '\n';
+                if (text.size() >= options.chunk_size) {
+                    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+                    text.clear();
+                }
+            }
+        } else {
+            records.resize(rows * (number_of_functions + 1));
+            int64_t* record = records.data();
+            for (size_t r = 0; r < rows; r++) {
+                uint64_t mask = 0;
+                for (size_t f = 0; f < number_of_functions; f++) {
+                    const size_t i = f * options.batch_size + r;
+                    *record++ = results[i];
+                    mask |= static_cast<uint64_t>(errors[i]) << f;
+                }
+                *record++ = static_cast<int64_t>(mask);
+            }
+            out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(int64_t)));
+        }
+        statistics.rows += rows;
+        statistics.batches++;
+        if (!out) {
+            std::cerr << "Writing the results failed" << std::endl;
+            success = false;
+            free_batches.Cancel();
+            break;
+        }
+    }
+    reader_thread.join();
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.flush();
+    if (!read_error.empty()) {
+        std::cerr << read_error << std::endl;
+    }
+    return success && read_error.empty() && out.good();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
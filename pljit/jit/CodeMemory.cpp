@@ -0,0 +1,159 @@
+//---------------------------------------------------------------------------
+#include "jit/CodeMemory.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <sys/mman.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Round up to a multiple of a power of two.
+static size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+//---------------------------------------------------------------------------
+CodeMemory::CodeMemory(size_t region_size, bool huge_pages) : region_size(region_size), huge_pages(huge_pages), page_size(static_cast<size_t>(sysconf(_SC_PAGESIZE))) {}
+//---------------------------------------------------------------------------
+CodeMemory::~CodeMemory() {
+    for (auto& region : regions) {
+        munmap(region.begin, region.size);
+    }
+}
+//---------------------------------------------------------------------------
+bool CodeMemory::MapRegion(size_t size) {
+    size = AlignUp(std::max(size, region_size), huge_pages ? huge_page_size : page_size);
+    const int protection = executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE;
+    // A huge page needs an aligned range, so a huge page more is mapped and the slack around the aligned region is unmapped.
+    const size_t slack = huge_pages ? huge_page_size : 0;
+    void* memory = mmap(nullptr, size + slack, protection, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        std::cerr << "Mapping code memory failed" << std::endl;
+        return false;
+    }
+    auto* mapped = static_cast<uint8_t*>(memory);
+    auto* begin = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<uintptr_t>(mapped), huge_pages ? huge_page_size : page_size));
+    if (begin != mapped) {
+        munmap(mapped, begin - mapped);
+    }
+    if (begin + size != mapped + size + slack) {
+        munmap(begin + size, mapped + size + slack - (begin + size));
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge_pages) {
+        // Only a hint: without transparent huge pages the region is backed by normal pages.
+        madvise(begin, size, MADV_HUGEPAGE);
+    }
+#endif
+    regions.push_back(Region{begin, size});
+    statistics.regions++;
+    statistics.mapped_bytes += size;
+    AddFreeBlock(begin, size);
+    return true;
+}
+//---------------------------------------------------------------------------
+void CodeMemory::AddFreeBlock(uint8_t* begin, size_t size) {
+    auto next = free_blocks.lower_bound(begin);
+    if (next != free_blocks.end() && begin + size == next->first) {
+        size += next->second;
+        next = free_blocks.erase(next);
+    }
+    if (next != free_blocks.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == begin) {
+            previous->second += size;
+            return;
+        }
+    }
+    free_blocks.emplace_hint(next, begin, size);
+}
+//---------------------------------------------------------------------------
+uint8_t* CodeMemory::Allocate(size_t size, size_t alignment) {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+    std::scoped_lock lock(mutex);
+    const size_t block_size = AlignUp(std::max<size_t>(size, 1), default_alignment);
+    for (bool mapped = false;; mapped = true) {
+        // First fit, so the code stays dense at the start of the regions.
+        for (auto it = free_blocks.begin(); it != free_blocks.end(); ++it) {
+            uint8_t* begin = it->first;
+            const size_t free_size = it->second;
+            auto* aligned = reinterpret_cast<uint8_t*>(AlignUp(reinterpret_cast<uintptr_t>(begin), alignment));
+            if (aligned + block_size > begin + free_size) {
+                continue;
+            }
+            free_blocks.erase(it);
+            if (aligned != begin) {
+                AddFreeBlock(begin, aligned - begin);
+            }
+            if (aligned + block_size != begin + free_size) {
+                AddFreeBlock(aligned + block_size, begin + free_size - aligned - block_size);
+            }
+            allocations.emplace(aligned, block_size);
+            statistics.allocated_bytes += block_size;
+            statistics.allocations++;
+            return aligned;
+        }
+        if (mapped || !MapRegion(block_size + alignment)) {
+            return nullptr;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void CodeMemory::Free(uint8_t* code) {
+    if (!code) {
+        return;
+    }
+    std::scoped_lock lock(mutex);
+    auto it = allocations.find(code);
+    if (it == allocations.end()) {
+        std::cerr << "Freeing unknown code memory" << std::endl;
+        return;
+    }
+    const size_t size = it->second;
+    allocations.erase(it);
+    statistics.allocated_bytes -= size;
+    statistics.allocations--;
+    AddFreeBlock(code, size);
+}
+//---------------------------------------------------------------------------
+bool CodeMemory::Protect(bool make_executable) {
+    if (executable == make_executable) {
+        return true;
+    }
+    const int protection = make_executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE;
+    for (auto& region : regions) {
+        if (mprotect(region.begin, region.size, protection) != 0) {
+            std::cerr << "Changing the protection of code memory failed" << std::endl;
+            return false;
+        }
+        if (make_executable) {
+            __builtin___clear_cache(reinterpret_cast<char*>(region.begin), reinterpret_cast<char*>(region.begin + region.size));
+        }
+    }
+    executable = make_executable;
+    statistics.protection_changes++;
+    return true;
+}
+//---------------------------------------------------------------------------
+bool CodeMemory::MakeWritable() {
+    std::scoped_lock lock(mutex);
+    return Protect(false);
+}
+//---------------------------------------------------------------------------
+bool CodeMemory::MakeExecutable() {
+    std::scoped_lock lock(mutex);
+    return Protect(true);
+}
+//---------------------------------------------------------------------------
+bool CodeMemory::IsExecutable() const {
+    std::scoped_lock lock(mutex);
+    return executable;
+}
+//---------------------------------------------------------------------------
+CodeMemory::Statistics CodeMemory::GetStatistics() const {
+    std::scoped_lock lock(mutex);
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,148 @@
+//---------------------------------------------------------------------------
+#include "jit/ColumnEvaluator.hpp"
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <iostream>
+#include <thread>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+ColumnEvaluator::ColumnEvaluator(FunctionHandle function) : ColumnEvaluator(function, Options()) {}
+//---------------------------------------------------------------------------
+ColumnEvaluator::ColumnEvaluator(FunctionHandle function, Options options) : function(function), options(options) {}
+//---------------------------------------------------------------------------
+const ColumnEvaluator::Statistics& ColumnEvaluator::GetStatistics() const { return statistics; }
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::ForEachMorsel(const std::vector<const int64_t*>& columns, size_t number_of_rows, const MorselFunction& process) {
+    statistics = Statistics();
+    const std::optional<size_t> number_of_parameters = function.GetNumberOfParameters();
+    if (!number_of_parameters) {
+        return false;
+    }
+    if (*number_of_parameters != columns.size()) {
+        std::cerr << "Wrong number of columns: expected " << *number_of_parameters << ", got " << columns.size() << std::endl;
+        return false;
+    }
+    const size_t morsel_rows = std::max<size_t>(options.morsel_rows, 1);
+    const size_t number_of_morsels = (number_of_rows + morsel_rows - 1) / morsel_rows;
+    const size_t threads = std::max<size_t>(std::min(GetMaxThreads(), number_of_morsels), 1);
+
+    if (!thread_pool) {
+        thread_pool = std::make_unique<ThreadPool>(GetMaxThreads());
+    }
+    std::atomic<bool> success = true;
+    thread_pool->ParallelFor(number_of_morsels, [&](size_t morsel, size_t thread) {
+        // The remaining morsels of a failed run are skipped.
+        if (!success.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const size_t begin = morsel * morsel_rows;
+        const size_t rows = std::min(morsel_rows, number_of_rows - begin);
+        std::vector<const int64_t*> morsel_columns(columns.size());
+        for (size_t c = 0; c < columns.size(); c++) {
+            morsel_columns[c] = columns[c] + begin;
+        }
+        if (!process(thread, morsel_columns.data(), begin, rows)) {
+            success = false;
+        }
+    });
+    statistics.rows = number_of_rows;
+    statistics.morsels = number_of_morsels;
+    statistics.threads = threads;
+    return success;
+}
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::Evaluate(const std::vector<const int64_t*>& columns, size_t number_of_rows, int64_t* results, uint8_t* errors) {
+    std::atomic<uint64_t> division_by_zero_errors = 0;
+    // Without an errors column, the errors of a morsel go to a scratch buffer of its thread.
+    std::vector<std::vector<uint8_t>> scratch(errors ? 0 : GetMaxThreads());
+    const bool success = ForEachMorsel(columns, number_of_rows, [&](size_t thread, const int64_t* const* morsel_columns, size_t begin, size_t rows) {
+        uint8_t* morsel_errors = errors ? errors + begin : nullptr;
+        if (!errors) {
+            scratch[thread].resize(rows);
+            morsel_errors = scratch[thread].data();
+        }
+        if (!function.CallColumns(morsel_columns, rows, results + begin, morsel_errors)) {
+            return false;
+        }
+        division_by_zero_errors += static_cast<uint64_t>(std::count(morsel_errors, morsel_errors + rows, 1));
+        return true;
+    });
+    statistics.division_by_zero_errors = division_by_zero_errors;
+    return success;
+}
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::Aggregate(const std::vector<const int64_t*>& columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates) {
+    // Each thread aggregates its morsels, the threads' aggregates are merged at the end.
+    std::vector<Aggregates> thread_aggregates(GetMaxThreads());
+    const bool success = ForEachMorsel(columns, number_of_rows, [&](size_t thread, const int64_t* const* morsel_columns, size_t, size_t rows) {
+        return function.AggregateColumns(morsel_columns, rows, aggregation, thread_aggregates[thread]);
+    });
+    for (auto& other : thread_aggregates) {
+        aggregates.Merge(other);
+    }
+    statistics.division_by_zero_errors = aggregates.errors;
+    return success;
+}
+//---------------------------------------------------------------------------
+size_t ColumnEvaluator::GetMaxThreads() const { return options.threads ? options.threads : std::max(std::thread::hardware_concurrency(), 1u); }
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::MapColumns(const std::vector<std::string>& input_paths, std::vector<MappedFile>& inputs, std::vector<const int64_t*>& columns, size_t& number_of_rows) {
+    if constexpr (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__) {
+        std::cerr << "Column files are little-endian, which this machine is not" << std::endl;
+        return false;
+    }
+    inputs.resize(input_paths.size());
+    std::optional<size_t> rows;
+    for (size_t c = 0; c < input_paths.size(); c++) {
+        if (!inputs[c].OpenRead(input_paths[c])) {
+            return false;
+        }
+        const size_t size = inputs[c].GetSize();
+        if (size % sizeof(int64_t) != 0 || (rows && *rows != size / sizeof(int64_t))) {
+            std::cerr << "The column has a different number of rows: " << input_paths[c] << std::endl;
+            return false;
+        }
+        rows = size / sizeof(int64_t);
+        // mmap returns page-aligned memory, so the integers are aligned.
+        columns.push_back(reinterpret_cast<const int64_t*>(inputs[c].GetData()));
+    }
+    if (!rows) {
+        std::cerr << "A function without parameters has no column to take the number of rows from" << std::endl;
+        return false;
+    }
+    number_of_rows = *rows;
+    return true;
+}
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::EvaluateFiles(const std::vector<std::string>& input_paths, const std::string& output_path, const std::string& errors_path) {
+    std::vector<MappedFile> inputs;
+    std::vector<const int64_t*> columns;
+    size_t number_of_rows;
+    if (!MapColumns(input_paths, inputs, columns, number_of_rows)) {
+        return false;
+    }
+    MappedFile output;
+    if (!output.Create(output_path, number_of_rows * sizeof(int64_t))) {
+        return false;
+    }
+    MappedFile errors;
+    if (!errors_path.empty() && !errors.Create(errors_path, number_of_rows)) {
+        return false;
+    }
+    return Evaluate(columns, number_of_rows, reinterpret_cast<int64_t*>(output.GetData()), errors_path.empty() ? nullptr : errors.GetData());
+}
+//---------------------------------------------------------------------------
+bool ColumnEvaluator::AggregateFiles(const std::vector<std::string>& input_paths, const Aggregation& aggregation, Aggregates& aggregates) {
+    std::vector<MappedFile> inputs;
+    std::vector<const int64_t*> columns;
+    size_t number_of_rows;
+    if (!MapColumns(input_paths, inputs, columns, number_of_rows)) {
+        return false;
+    }
+    return Aggregate(columns, number_of_rows, aggregation, aggregates);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------
+#include "jit/FunctionPipeline.hpp"
+#include <algorithm>
+#include <iostream>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+FunctionPipeline::FunctionPipeline(FunctionHandle function) { stages.push_back(Stage{function, {}}); }
+//---------------------------------------------------------------------------
+FunctionPipeline& FunctionPipeline::Then(FunctionHandle function, std::string parameter) {
+    stages.push_back(Stage{function, std::move(parameter)});
+    ir.reset();
+    return *this;
+}
+//---------------------------------------------------------------------------
+bool FunctionPipeline::Compile() {
+    if (ir) {
+        return true;
+    }
+    IRBuilder builder;
+    size_t number_of_parameters = 0;
+    uint32_t result = 0;
+    for (size_t s = 0; s < stages.size(); s++) {
+        FunctionHandle& function = stages[s].function;
+        if (!function.EnsureCompiled()) {
+            return false;
+        }
+        // A compiled slot keeps its IR and its parameters, so they are used without the function's mutex.
+        JIT::FunctionSlot* slot;
+        {
+            std::scoped_lock lock_reg(function.jit->register_mutex);
+            slot = function.jit->functions[function.index].get();
+        }
+        const std::vector<std::string_view>& parameters = slot->parameters;
+        auto fed = parameters.end();
+        if (s > 0) {
+            fed = std::find(parameters.begin(), parameters.end(), stages[s].parameter);
+            if (fed == parameters.end()) {
+                std::cerr << "Unknown parameter " << stages[s].parameter << " of the function " << s << " of the pipeline" << std::endl;
+                return false;
+            }
+        }
+        std::vector<uint32_t> arguments;
+        for (auto it = parameters.begin(); it != parameters.end(); ++it) {
+            arguments.push_back(it == fed ? result : builder.AddParameter(number_of_parameters++));
+        }
+        result = builder.AddInlined(*slot->ir, arguments);
+    }
+    ir = std::make_unique<IRFunction>(builder.BuildReturn(result, number_of_parameters));
+    return true;
+}
+//---------------------------------------------------------------------------
+std::optional<size_t> FunctionPipeline::GetNumberOfParameters() {
+    if (!Compile()) {
+        return std::nullopt;
+    }
+    return ir->GetNumberOfParameters();
+}
+//---------------------------------------------------------------------------
+const IRFunction* FunctionPipeline::GetIR() const { return ir.get(); }
+//---------------------------------------------------------------------------
+std::optional<int64_t> FunctionPipeline::Call(const int64_t* arguments, size_t number_of_arguments) {
+    if (!Compile()) {
+        return std::nullopt;
+    }
+    if (number_of_arguments != ir->GetNumberOfParameters()) {
+        std::cerr << "Wrong number of arguments: expected " << ir->GetNumberOfParameters() << ", got " << number_of_arguments << std::endl;
+        return std::nullopt;
+    }
+    const std::optional<int64_t> result = ir->Evaluate(arguments);
+    if (!result) {
+        std::cerr << "Division by zero error" << std::endl;
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+bool FunctionPipeline::CallBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors) {
+    if (!Compile()) {
+        return false;
+    }
+    ir->EvaluateBatch(arguments, number_of_rows, results, errors);
+    return true;
+}
+//---------------------------------------------------------------------------
+bool FunctionPipeline::CallColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors) {
+    if (!Compile()) {
+        return false;
+    }
+    ir->EvaluateColumns(columns, number_of_rows, results, errors);
+    return true;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
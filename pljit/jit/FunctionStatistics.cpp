@@ -0,0 +1,84 @@
+//---------------------------------------------------------------------------
+#include "jit/FunctionStatistics.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+FunctionStatistics::~FunctionStatistics() {
+    delete[] shards.load(std::memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+FunctionStatistics::Shard& FunctionStatistics::GetShard() {
+    // The threads are assigned to the shards round robin on their first call.
+    static std::atomic<size_t> next_shard = 0;
+    thread_local const size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % number_of_shards;
+    Shard* current = shards.load(std::memory_order_acquire);
+    if (!current) {
+        // Concurrent first calls race to install their shards, the losers free theirs.
+        auto* allocated = new Shard[number_of_shards];
+        if (shards.compare_exchange_strong(current, allocated, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            current = allocated;
+        } else {
+            delete[] allocated;
+        }
+    }
+    return current[shard];
+}
+//---------------------------------------------------------------------------
+void FunctionStatistics::RecordCall(uint64_t evaluation_ns, bool division_by_zero) {
+    Shard& shard = GetShard();
+    // Threads sharing a shard may record concurrently, so the counters are updated atomically.
+    shard.calls.fetch_add(1, std::memory_order_relaxed);
+    shard.total_evaluation_ns.fetch_add(evaluation_ns, std::memory_order_relaxed);
+    uint64_t max = shard.max_evaluation_ns.load(std::memory_order_relaxed);
+    while (evaluation_ns > max && !shard.max_evaluation_ns.compare_exchange_weak(max, evaluation_ns, std::memory_order_relaxed)) {}
+    if (division_by_zero) {
+        shard.division_by_zero_errors.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+//---------------------------------------------------------------------------
+void FunctionStatistics::RecordBatch(uint64_t rows, uint64_t evaluation_ns, uint64_t division_by_zero_errors) {
+    Shard& shard = GetShard();
+    shard.calls.fetch_add(rows, std::memory_order_relaxed);
+    shard.total_evaluation_ns.fetch_add(evaluation_ns, std::memory_order_relaxed);
+    shard.division_by_zero_errors.fetch_add(division_by_zero_errors, std::memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+void FunctionStatistics::RecordCompilePhase(CompilePhase phase, uint64_t ns, uint64_t allocations, uint64_t peak_bytes) {
+    const auto index = static_cast<size_t>(phase);
+    compile_ns[index].fetch_add(ns, std::memory_order_relaxed);
+    compile_allocations[index].fetch_add(allocations, std::memory_order_relaxed);
+    // A failed compilation is repeated by the next call, which has the same peak.
+    uint64_t peak = compile_peak_bytes[index].load(std::memory_order_relaxed);
+    while (peak_bytes > peak && !compile_peak_bytes[index].compare_exchange_weak(peak, peak_bytes, std::memory_order_relaxed)) {}
+}
+//---------------------------------------------------------------------------
+void FunctionStatistics::SetTier(Tier new_tier) {
+    tier.store(new_tier, std::memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+FunctionStatistics::Snapshot FunctionStatistics::GetSnapshot() const {
+    Snapshot snapshot;
+    const Shard* current = shards.load(std::memory_order_acquire);
+    for (size_t s = 0; current && s < number_of_shards; s++) {
+        const Shard& shard = current[s];
+        snapshot.calls += shard.calls.load(std::memory_order_relaxed);
+        snapshot.total_evaluation_ns += shard.total_evaluation_ns.load(std::memory_order_relaxed);
+        snapshot.max_evaluation_ns = std::max(snapshot.max_evaluation_ns, shard.max_evaluation_ns.load(std::memory_order_relaxed));
+        snapshot.division_by_zero_errors += shard.division_by_zero_errors.load(std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < number_of_phases; i++) {
+        snapshot.compile_ns[i] = compile_ns[i].load(std::memory_order_relaxed);
+        snapshot.compile_allocations[i] = compile_allocations[i].load(std::memory_order_relaxed);
+        snapshot.compile_peak_bytes[i] = compile_peak_bytes[i].load(std::memory_order_relaxed);
+    }
+    snapshot.tier = tier.load(std::memory_order_relaxed);
+    return snapshot;
+}
+//---------------------------------------------------------------------------
+size_t FunctionStatistics::GetMemoryUsage() const {
+    return shards.load(std::memory_order_relaxed) ? number_of_shards * sizeof(Shard) : 0;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,83 @@
+//---------------------------------------------------------------------------
+#include "jit/FusedKernel.hpp"
+#include <chrono>
+#include <iostream>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+FusedKernel::FusedKernel(std::vector<FunctionHandle> functions) : functions(std::move(functions)) {}
+//---------------------------------------------------------------------------
+bool FusedKernel::Compile() {
+    if (ir) {
+        return true;
+    }
+    if (functions.empty()) {
+        std::cerr << "Nothing to fuse" << std::endl;
+        return false;
+    }
+    IRBuilder builder;
+    std::optional<size_t> number_of_parameters;
+    statistics.clear();
+    for (auto& function : functions) {
+        if (!function.EnsureCompiled()) {
+            return false;
+        }
+        // A compiled slot keeps its IR, so it is used without the function's mutex.
+        JIT::FunctionSlot* slot;
+        {
+            std::scoped_lock lock_reg(function.jit->register_mutex);
+            slot = function.jit->functions[function.index].get();
+        }
+        const size_t parameters = slot->ir->GetNumberOfParameters();
+        if (number_of_parameters && *number_of_parameters != parameters) {
+            std::cerr << "The functions take different numbers of parameters: " << *number_of_parameters << " and " << parameters << std::endl;
+            return false;
+        }
+        number_of_parameters = parameters;
+        builder.AddFunction(*slot->ir);
+        statistics.push_back(&slot->statistics);
+    }
+    ir = std::make_unique<FusedIRFunction>(builder.BuildFused());
+    return true;
+}
+//---------------------------------------------------------------------------
+bool FusedKernel::EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors) {
+    return EvaluateRows(arguments, nullptr, number_of_rows, results, errors);
+}
+//---------------------------------------------------------------------------
+bool FusedKernel::EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors) {
+    return EvaluateRows(nullptr, columns, number_of_rows, results, errors);
+}
+//---------------------------------------------------------------------------
+bool FusedKernel::EvaluateRows(const int64_t* arguments, const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors) {
+    if (!Compile()) {
+        return false;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    std::vector<uint64_t> number_of_errors(functions.size());
+    if (arguments) {
+        ir->EvaluateBatch(arguments, number_of_rows, results, errors, number_of_errors.data());
+    } else {
+        ir->EvaluateColumns(columns, number_of_rows, results, errors, number_of_errors.data());
+    }
+    // The functions share the pass, so each one is charged its share of the time.
+    const auto ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+    for (size_t f = 0; f < statistics.size(); f++) {
+        statistics[f]->RecordBatch(number_of_rows, ns / statistics.size(), number_of_errors[f]);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+size_t FusedKernel::GetNumberOfFunctions() const { return functions.size(); }
+//---------------------------------------------------------------------------
+std::optional<size_t> FusedKernel::GetNumberOfParameters() {
+    if (!Compile()) {
+        return std::nullopt;
+    }
+    return ir->GetNumberOfParameters();
+}
+//---------------------------------------------------------------------------
+const FusedIRFunction* FusedKernel::GetIR() const { return ir.get(); }
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,626 @@
+//---------------------------------------------------------------------------
+#include "jit/IR.hpp"
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+IRFunction::IRFunction(std::vector<Instruction> instructions, uint32_t number_of_registers, size_t number_of_parameters)
+ : instructions(std::move(instructions)), number_of_registers(number_of_registers), number_of_parameters(number_of_parameters) {
+    assert(!this->instructions.empty());
+    assert(this->instructions.back().opcode == Instruction::Opcode::Return);
+}
+//---------------------------------------------------------------------------
+const std::vector<Instruction>& IRFunction::GetInstructions() const { return instructions; }
+//---------------------------------------------------------------------------
+uint32_t IRFunction::GetNumberOfRegisters() const { return number_of_registers; }
+//---------------------------------------------------------------------------
+size_t IRFunction::GetNumberOfParameters() const { return number_of_parameters; }
+//---------------------------------------------------------------------------
+void Aggregates::Merge(const Aggregates& other) {
+    count += other.count;
+    errors += other.errors;
+    sum = static_cast<int64_t>(static_cast<uint64_t>(sum) + static_cast<uint64_t>(other.sum));
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    histogram.resize(std::max(histogram.size(), other.histogram.size()));
+    for (size_t b = 0; b < other.histogram.size(); b++) {
+        histogram[b] += other.histogram[b];
+    }
+}
+//---------------------------------------------------------------------------
+std::optional<int64_t> IRFunction::Evaluate(const int64_t* arguments) const {
+    std::vector<int64_t> registers(number_of_registers);
+    for (auto& instruction : instructions) {
+        int64_t& destination = registers[instruction.destination];
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Constant: destination = instruction.value; break;
+            case Instruction::Opcode::Parameter: destination = arguments[instruction.value]; break;
+            case Instruction::Opcode::Negate: destination = -1 * registers[instruction.left]; break;
+            case Instruction::Opcode::Add: destination = registers[instruction.left] + registers[instruction.right]; break;
+            case Instruction::Opcode::Sub: destination = registers[instruction.left] - registers[instruction.right]; break;
+            case Instruction::Opcode::Mul: destination = registers[instruction.left] * registers[instruction.right]; break;
+            case Instruction::Opcode::Div:
+                if (registers[instruction.right] == 0) {
+                    return std::nullopt;
+                }
+                destination = registers[instruction.left] / registers[instruction.right];
+                break;
+            case Instruction::Opcode::Return: return registers[instruction.left];
+        }
+    }
+    __builtin_unreachable();  // Must have "RETURN".
+}
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The 128 bit integers of gcc and clang.
+__extension__ using Int128 = __int128;
+__extension__ using UInt128 = unsigned __int128;
+//---------------------------------------------------------------------------
+/// A signed division by a divisor, which is the same for all rows, as a multiplication with a precomputed reciprocal and shifts.
+/// The reciprocal follows libdivide's algorithm for signed 64 bit integers, the quotient is truncated like the division operator.
+class InvariantDivisor {
+    public:
+    /// Constructor. The divisor is not 0.
+    explicit InvariantDivisor(int64_t divisor) {
+        assert(divisor != 0);
+        const uint64_t absolute = divisor < 0 ? 0 - static_cast<uint64_t>(divisor) : static_cast<uint64_t>(divisor);
+        const auto log2 = static_cast<uint8_t>(63 - __builtin_clzll(absolute));
+        if ((absolute & (absolute - 1)) == 0) {
+            // A power of two: a shift.
+            magic = 0;
+            more = static_cast<uint8_t>(log2 | (divisor < 0 ? negative_divisor : 0));
+            return;
+        }
+        const UInt128 numerator = static_cast<UInt128>(uint64_t(1) << (log2 - 1)) << 64;
+        auto proposed = static_cast<uint64_t>(numerator / absolute);
+        const auto remainder = static_cast<uint64_t>(numerator % absolute);
+        if (absolute - remainder < (uint64_t(1) << log2)) {
+            more = static_cast<uint8_t>(log2 - 1);
+        } else {
+            // The reciprocal needs 65 bits: its top bit is added as the numerator.
+            proposed += proposed;
+            const uint64_t twice_remainder = remainder + remainder;
+            if (twice_remainder >= absolute || twice_remainder < remainder) {
+                proposed += 1;
+            }
+            more = static_cast<uint8_t>(log2 | add_marker);
+        }
+        proposed += 1;
+        magic = static_cast<int64_t>(divisor < 0 ? 0 - proposed : proposed);
+        more |= divisor < 0 ? negative_divisor : 0;
+    }
+    /// Divide a block of rows.
+    void DivideBlock(const int64_t* numerators, int64_t* quotients, size_t rows) const {
+        const unsigned shift = more & shift_mask;
+        const auto sign = static_cast<int64_t>(static_cast<int8_t>(more) >> 7);
+        if (magic == 0) {
+            // Round towards zero: add divisor - 1 to a negative numerator before the arithmetic shift.
+            const uint64_t mask = (uint64_t(1) << shift) - 1;
+            for (size_t r = 0; r < rows; r++) {
+                const auto numerator = static_cast<uint64_t>(numerators[r]);
+                const auto quotient = static_cast<int64_t>(numerator + ((numerator >> 63) * mask)) >> shift;
+                quotients[r] = static_cast<int64_t>((static_cast<uint64_t>(quotient) ^ static_cast<uint64_t>(sign)) - static_cast<uint64_t>(sign));
+            }
+        } else if (more & add_marker) {
+            for (size_t r = 0; r < rows; r++) {
+                uint64_t high = MultiplyHigh(magic, numerators[r]);
+                high += (static_cast<uint64_t>(numerators[r]) ^ static_cast<uint64_t>(sign)) - static_cast<uint64_t>(sign);
+                const int64_t quotient = static_cast<int64_t>(high) >> shift;
+                quotients[r] = quotient + (quotient < 0);
+            }
+        } else {
+            for (size_t r = 0; r < rows; r++) {
+                const int64_t quotient = static_cast<int64_t>(MultiplyHigh(magic, numerators[r])) >> shift;
+                quotients[r] = quotient + (quotient < 0);
+            }
+        }
+    }
+
+    private:
+    /// The bits of `more`.
+    static constexpr uint8_t shift_mask = 0x3F;
+    static constexpr uint8_t add_marker = 0x40;
+    static constexpr uint8_t negative_divisor = 0x80;
+    /// The reciprocal, 0 for a power of two.
+    int64_t magic;
+    /// The shift and the flags.
+    uint8_t more;
+
+    /// The high 64 bits of the 128 bit product.
+    static uint64_t MultiplyHigh(int64_t a, int64_t b) { return static_cast<uint64_t>((static_cast<Int128>(a) * b) >> 64); }
+};
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+/// Execute an instruction but "RETURN" for a block of rows. The value of parameter p in row r is `parameters[p][r * stride]`.
+/// With `block_errors`, a division flags the rows dividing by zero.
+static void ExecuteBlock(const Instruction& instruction, int64_t* registers, const int64_t* const* parameters, size_t stride, size_t begin, size_t rows, uint8_t* block_errors) {
+    constexpr size_t block_size = IRFunction::batch_block_size;
+    int64_t* destination = &registers[instruction.destination * block_size];
+    const int64_t* left = &registers[instruction.left * block_size];
+    const int64_t* right = &registers[instruction.right * block_size];
+    switch (instruction.opcode) {
+        case Instruction::Opcode::Constant: std::fill(destination, destination + rows, instruction.value); break;
+        case Instruction::Opcode::Parameter:
+            {
+                const int64_t* parameter = parameters[instruction.value] + begin * stride;
+                if (stride == 1) {
+                    std::copy(parameter, parameter + rows, destination);
+                } else {
+                    for (size_t r = 0; r < rows; r++) { destination[r] = parameter[r * stride]; }
+                }
+            }
+            break;
+        case Instruction::Opcode::Negate: for (size_t r = 0; r < rows; r++) { destination[r] = -1 * left[r]; } break;
+        case Instruction::Opcode::Add: for (size_t r = 0; r < rows; r++) { destination[r] = left[r] + right[r]; } break;
+        case Instruction::Opcode::Sub: for (size_t r = 0; r < rows; r++) { destination[r] = left[r] - right[r]; } break;
+        case Instruction::Opcode::Mul: for (size_t r = 0; r < rows; r++) { destination[r] = left[r] * right[r]; } break;
+        case Instruction::Opcode::Div:
+            // The failed rows divide by 1, so the loop has no branch and continues with the other rows.
+            for (size_t r = 0; r < rows; r++) {
+                destination[r] = left[r] / (right[r] == 0 ? 1 : right[r]);
+            }
+            if (block_errors) {
+                for (size_t r = 0; r < rows; r++) { block_errors[r] |= right[r] == 0; }
+            }
+            break;
+        case Instruction::Opcode::Return: assert(false); break;
+    }
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors) const {
+    Sink sink;
+    sink.results = results;
+    sink.errors = errors;
+    return EvaluateRowMajor(arguments, number_of_rows, sink);
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors, const std::vector<bool>* scalar_parameters) const {
+    Sink sink;
+    sink.results = results;
+    sink.errors = errors;
+    return EvaluateBlocks(columns, 1, number_of_rows, sink, scalar_parameters);
+}
+//---------------------------------------------------------------------------
+void IRFunction::AggregateBatch(const int64_t* arguments, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates) const {
+    Sink sink;
+    sink.aggregation = &aggregation;
+    sink.aggregates = &aggregates;
+    EvaluateRowMajor(arguments, number_of_rows, sink);
+}
+//---------------------------------------------------------------------------
+void IRFunction::AggregateColumns(const int64_t* const* columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates, const std::vector<bool>* scalar_parameters) const {
+    Sink sink;
+    sink.aggregation = &aggregation;
+    sink.aggregates = &aggregates;
+    EvaluateBlocks(columns, 1, number_of_rows, sink, scalar_parameters);
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::SelectBatch(const int64_t* arguments, size_t number_of_rows, uint32_t* selection, size_t& number_of_errors) const {
+    Sink sink;
+    sink.selection = selection;
+    number_of_errors = EvaluateRowMajor(arguments, number_of_rows, sink);
+    return sink.selected;
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::SelectColumns(const int64_t* const* columns, size_t number_of_rows, uint32_t* selection, size_t& number_of_errors, const std::vector<bool>* scalar_parameters) const {
+    Sink sink;
+    sink.selection = selection;
+    number_of_errors = EvaluateBlocks(columns, 1, number_of_rows, sink, scalar_parameters);
+    return sink.selected;
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::EvaluateRowMajor(const int64_t* arguments, size_t number_of_rows, Sink& sink) const {
+    std::vector<const int64_t*> parameters(number_of_parameters);
+    for (size_t p = 0; p < number_of_parameters; p++) {
+        parameters[p] = arguments + p;
+    }
+    return EvaluateBlocks(parameters.data(), number_of_parameters, number_of_rows, sink);
+}
+//---------------------------------------------------------------------------
+/// Add the results of a block to the aggregates.
+static void AggregateBlock(const int64_t* values, const uint8_t* block_errors, size_t rows, const Aggregation& aggregation, Aggregates& aggregates) {
+    // Without branches on the errors: a failed row adds 0 to the count and the sum and keeps the minimum and the maximum.
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    int64_t min = aggregates.min;
+    int64_t max = aggregates.max;
+    for (size_t r = 0; r < rows; r++) {
+        const uint64_t valid = block_errors[r] ^ 1u;
+        const int64_t value = values[r];
+        count += valid;
+        sum += static_cast<uint64_t>(value) & (0 - valid);
+        min = valid && value < min ? value : min;
+        max = valid && value > max ? value : max;
+    }
+    aggregates.count += count;
+    aggregates.errors += rows - count;
+    aggregates.sum = static_cast<int64_t>(static_cast<uint64_t>(aggregates.sum) + sum);
+    aggregates.min = min;
+    aggregates.max = max;
+    if (aggregation.histogram_width == 0 || aggregation.histogram_buckets == 0) {
+        return;
+    }
+    aggregates.histogram.resize(aggregation.histogram_buckets);
+    const uint64_t last = aggregation.histogram_buckets - 1;
+    for (size_t r = 0; r < rows; r++) {
+        const int64_t value = values[r];
+        const uint64_t offset = value < aggregation.histogram_lower ? 0 : (static_cast<uint64_t>(value) - static_cast<uint64_t>(aggregation.histogram_lower)) / aggregation.histogram_width;
+        aggregates.histogram[std::min(offset, last)] += block_errors[r] ^ 1u;
+    }
+}
+//---------------------------------------------------------------------------
+size_t IRFunction::EvaluateBlocks(const int64_t* const* parameters, size_t stride, size_t number_of_rows, Sink& sink, const std::vector<bool>* scalar_parameters) const {
+    assert(!sink.selection || number_of_rows <= std::numeric_limits<uint32_t>::max());
+    assert(!scalar_parameters || scalar_parameters->size() == number_of_parameters);
+    std::vector<int64_t> registers(static_cast<size_t>(number_of_registers) * batch_block_size);
+
+    // The instructions depending only on constants and scalar parameters are invariant: they are evaluated once,
+    // and their registers are filled once for all blocks. A division by an invariant divisor multiplies with its reciprocal.
+    struct Step {
+        /// The instruction.
+        const Instruction* instruction;
+        /// The reciprocal of an invariant, non-zero divisor.
+        std::optional<InvariantDivisor> divisor;
+    };
+    std::vector<Step> steps;
+    std::vector<bool> invariant(number_of_registers);
+    bool invariant_error = false;
+    const Instruction* return_instruction = nullptr;
+    for (auto& instruction : instructions) {
+        const uint32_t destination = instruction.destination;
+        int64_t value = 0;
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Return: return_instruction = &instruction; continue;
+            case Instruction::Opcode::Constant: value = instruction.value; break;
+            case Instruction::Opcode::Parameter:
+                if (!scalar_parameters || !(*scalar_parameters)[instruction.value]) {
+                    steps.push_back(Step{&instruction, std::nullopt});
+                    continue;
+                }
+                value = parameters[instruction.value][0];
+                break;
+            case Instruction::Opcode::Negate:
+                if (!invariant[instruction.left]) {
+                    steps.push_back(Step{&instruction, std::nullopt});
+                    continue;
+                }
+                value = -1 * registers[instruction.left * batch_block_size];
+                break;
+            default:
+                {
+                    const int64_t left = registers[instruction.left * batch_block_size];
+                    const int64_t right = registers[instruction.right * batch_block_size];
+                    if (!invariant[instruction.left] || !invariant[instruction.right]) {
+                        std::optional<InvariantDivisor> divisor;
+                        if (instruction.opcode == Instruction::Opcode::Div && invariant[instruction.right] && right != 0) {
+                            divisor.emplace(right);
+                        }
+                        steps.push_back(Step{&instruction, divisor});
+                        continue;
+                    }
+                    switch (instruction.opcode) {
+                        case Instruction::Opcode::Add: value = left + right; break;
+                        case Instruction::Opcode::Sub: value = left - right; break;
+                        case Instruction::Opcode::Mul: value = left * right; break;
+                        default:
+                            // An invariant division by zero fails all rows.
+                            invariant_error = invariant_error || right == 0;
+                            value = left / (right == 0 ? 1 : right);
+                            break;
+                    }
+                }
+                break;
+        }
+        invariant[destination] = true;
+        std::fill(&registers[destination * batch_block_size], &registers[(destination + 1) * batch_block_size], value);
+    }
+    assert(return_instruction);
+
+    // The errors of a block, when they are not stored.
+    std::vector<uint8_t> scratch(sink.results ? 0 : batch_block_size);
+    size_t number_of_errors = 0;
+    for (size_t begin = 0; begin < number_of_rows; begin += batch_block_size) {
+        const size_t rows = std::min(batch_block_size, number_of_rows - begin);
+        uint8_t* block_errors = sink.results ? sink.errors + begin : scratch.data();
+        std::fill(block_errors, block_errors + rows, invariant_error);
+        for (auto& step : steps) {
+            const Instruction& instruction = *step.instruction;
+            if (step.divisor) {
+                step.divisor->DivideBlock(&registers[instruction.left * batch_block_size], &registers[instruction.destination * batch_block_size], rows);
+            } else {
+                ExecuteBlock(instruction, registers.data(), parameters, stride, begin, rows, block_errors);
+            }
+        }
+        const int64_t* value = &registers[return_instruction->left * batch_block_size];
+        if (sink.aggregates) {
+            AggregateBlock(value, block_errors, rows, *sink.aggregation, *sink.aggregates);
+        } else if (sink.selection) {
+            // Every row is written, but only the selected ones advance the position.
+            uint32_t* selection = sink.selection;
+            size_t selected = sink.selected;
+            for (size_t r = 0; r < rows; r++) {
+                selection[selected] = static_cast<uint32_t>(begin + r);
+                selected += (value[r] != 0) & (block_errors[r] ^ 1u);
+                number_of_errors += block_errors[r];
+            }
+            sink.selected = selected;
+        } else {
+            for (size_t r = 0; r < rows; r++) {
+                sink.results[begin + r] = block_errors[r] ? 0 : value[r];
+                number_of_errors += block_errors[r];
+            }
+        }
+    }
+    return number_of_errors;
+}
+//---------------------------------------------------------------------------
+/// Print an instruction but "RETURN".
+static void PrintInstruction(const Instruction& instruction, std::ostream& out) {
+    const char* name = nullptr;
+    switch (instruction.opcode) {
+        case Instruction::Opcode::Constant: out << "%" << instruction.destination << " = const " << instruction.value << "\n"; return;
+        case Instruction::Opcode::Parameter: out << "%" << instruction.destination << " = param " << instruction.value << "\n"; return;
+        case Instruction::Opcode::Negate: out << "%" << instruction.destination << " = neg %" << instruction.left << "\n"; return;
+        case Instruction::Opcode::Return: out << "ret %" << instruction.left << "\n"; return;
+        case Instruction::Opcode::Add: name = "add"; break;
+        case Instruction::Opcode::Sub: name = "sub"; break;
+        case Instruction::Opcode::Mul: name = "mul"; break;
+        case Instruction::Opcode::Div: name = "div"; break;
+    }
+    out << "%" << instruction.destination << " = " << name << " %" << instruction.left << ", %" << instruction.right << "\n";
+}
+//---------------------------------------------------------------------------
+void IRFunction::Print(std::ostream& out) const {
+    for (auto& instruction : instructions) {
+        PrintInstruction(instruction, out);
+    }
+}
+//---------------------------------------------------------------------------
+FusedIRFunction::FusedIRFunction(std::vector<Instruction> instructions, std::vector<Output> outputs, uint32_t number_of_registers, size_t number_of_parameters)
+ : instructions(std::move(instructions)), outputs(std::move(outputs)), number_of_registers(number_of_registers), number_of_parameters(number_of_parameters) {}
+//---------------------------------------------------------------------------
+const std::vector<Instruction>& FusedIRFunction::GetInstructions() const { return instructions; }
+//---------------------------------------------------------------------------
+const std::vector<FusedIRFunction::Output>& FusedIRFunction::GetOutputs() const { return outputs; }
+//---------------------------------------------------------------------------
+size_t FusedIRFunction::GetNumberOfParameters() const { return number_of_parameters; }
+//---------------------------------------------------------------------------
+void FusedIRFunction::EvaluateBatch(const int64_t* arguments, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const {
+    std::vector<const int64_t*> parameters(number_of_parameters);
+    for (size_t p = 0; p < number_of_parameters; p++) {
+        parameters[p] = arguments + p;
+    }
+    EvaluateBlocks(parameters.data(), number_of_parameters, number_of_rows, results, errors, number_of_errors);
+}
+//---------------------------------------------------------------------------
+void FusedIRFunction::EvaluateColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const {
+    EvaluateBlocks(columns, 1, number_of_rows, results, errors, number_of_errors);
+}
+//---------------------------------------------------------------------------
+void FusedIRFunction::EvaluateBlocks(const int64_t* const* parameters, size_t stride, size_t number_of_rows, int64_t* const* results, uint8_t* const* errors, uint64_t* number_of_errors) const {
+    std::vector<int64_t> registers(static_cast<size_t>(number_of_registers) * IRFunction::batch_block_size);
+    for (size_t begin = 0; begin < number_of_rows; begin += IRFunction::batch_block_size) {
+        const size_t rows = std::min(IRFunction::batch_block_size, number_of_rows - begin);
+        for (auto& instruction : instructions) {
+            ExecuteBlock(instruction, registers.data(), parameters, stride, begin, rows, nullptr);
+        }
+        // The registers of the block are kept, so the outputs find their divisors in them.
+        for (size_t o = 0; o < outputs.size(); o++) {
+            uint8_t* block_errors = errors[o] + begin;
+            std::fill(block_errors, block_errors + rows, 0);
+            for (uint32_t divisor : outputs[o].divisors) {
+                const int64_t* values = &registers[divisor * IRFunction::batch_block_size];
+                for (size_t r = 0; r < rows; r++) { block_errors[r] |= values[r] == 0; }
+            }
+            const int64_t* value = &registers[outputs[o].value * IRFunction::batch_block_size];
+            int64_t* block_results = results[o] + begin;
+            uint64_t block_number_of_errors = 0;
+            for (size_t r = 0; r < rows; r++) {
+                block_results[r] = block_errors[r] ? 0 : value[r];
+                block_number_of_errors += block_errors[r];
+            }
+            number_of_errors[o] += block_number_of_errors;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+void FusedIRFunction::Print(std::ostream& out) const {
+    for (auto& instruction : instructions) {
+        PrintInstruction(instruction, out);
+    }
+    for (size_t o = 0; o < outputs.size(); o++) {
+        out << "out " << o << " = %" << outputs[o].value;
+        for (uint32_t divisor : outputs[o].divisors) {
+            out << (divisor == outputs[o].divisors.front() ? " unless zero %" : ", %") << divisor;
+        }
+        out << "\n";
+    }
+}
+//---------------------------------------------------------------------------
+size_t IRBuilder::KeyHash::operator()(const Key& key) const {
+    size_t hash = static_cast<size_t>(key.opcode);
+    hash = hash * 0x9E3779B97F4A7C15ull + key.left;
+    hash = hash * 0x9E3779B97F4A7C15ull + key.right;
+    hash = hash * 0x9E3779B97F4A7C15ull + static_cast<size_t>(key.value);
+    return hash ^ (hash >> 29);
+}
+//---------------------------------------------------------------------------
+IRBuilder::IRBuilder(const SymbolTable& symbol_table, const std::vector<std::string_view>& parameters) : symbol_table(&symbol_table), parameters(&parameters) {}
+//---------------------------------------------------------------------------
+IRFunction IRBuilder::Build(FunctionAST& node) {
+    Visit(node);
+    assert(returned);
+    return IRFunction(std::move(instructions), static_cast<uint32_t>(values.size()), parameters->size());
+}
+//---------------------------------------------------------------------------
+void IRBuilder::AddFunction(const IRFunction& function) {
+    assert(outputs.empty() || number_of_parameters == function.GetNumberOfParameters());
+    number_of_parameters = function.GetNumberOfParameters();
+    fused = true;
+    divisors.clear();
+    const uint32_t value = Copy(function, nullptr);
+    std::sort(divisors.begin(), divisors.end());
+    divisors.erase(std::unique(divisors.begin(), divisors.end()), divisors.end());
+    outputs.push_back(FusedIRFunction::Output{value, divisors});
+}
+//---------------------------------------------------------------------------
+FusedIRFunction IRBuilder::BuildFused() {
+    return FusedIRFunction(std::move(instructions), std::move(outputs), static_cast<uint32_t>(values.size()), number_of_parameters);
+}
+//---------------------------------------------------------------------------
+uint32_t IRBuilder::AddParameter(size_t index) { return Emit(Instruction::Opcode::Parameter, 0, 0, static_cast<int64_t>(index)); }
+//---------------------------------------------------------------------------
+uint32_t IRBuilder::AddInlined(const IRFunction& function, const std::vector<uint32_t>& arguments) {
+    assert(arguments.size() == function.GetNumberOfParameters());
+    return Copy(function, arguments.data());
+}
+//---------------------------------------------------------------------------
+IRFunction IRBuilder::BuildReturn(uint32_t value, size_t function_parameters) {
+    // Mark the instructions the return value and the divisions depend on, the operands precede their users.
+    std::vector<bool> live(instructions.size());
+    live[value] = true;
+    for (size_t i = instructions.size(); i-- > 0;) {
+        const Instruction& instruction = instructions[i];
+        live[i] = live[i] || instruction.opcode == Instruction::Opcode::Div;
+        if (!live[i] || instruction.opcode == Instruction::Opcode::Constant || instruction.opcode == Instruction::Opcode::Parameter) {
+            continue;
+        }
+        live[instruction.left] = true;
+        if (instruction.opcode != Instruction::Opcode::Negate) {
+            live[instruction.right] = true;
+        }
+    }
+    std::vector<Instruction> live_instructions;
+    for (size_t i = 0; i < instructions.size(); i++) {
+        if (live[i]) {
+            live_instructions.push_back(instructions[i]);
+        }
+    }
+    live_instructions.push_back(Instruction{Instruction::Opcode::Return, 0, value, 0, 0});
+    instructions.clear();
+    return IRFunction(std::move(live_instructions), static_cast<uint32_t>(values.size()), function_parameters);
+}
+//---------------------------------------------------------------------------
+uint32_t IRBuilder::Copy(const IRFunction& function, const uint32_t* arguments) {
+    // The function's registers are numbered again, so the parameters and the identical computations are shared with the other functions.
+    std::vector<uint32_t> registers(function.GetInstructions().size());
+    for (auto& instruction : function.GetInstructions()) {
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Return: return registers[instruction.left];
+            case Instruction::Opcode::Parameter:
+                registers[instruction.destination] = arguments ? arguments[instruction.value] : Emit(instruction.opcode, 0, 0, instruction.value);
+                break;
+            case Instruction::Opcode::Constant: registers[instruction.destination] = Emit(instruction.opcode, 0, 0, instruction.value); break;
+            case Instruction::Opcode::Negate: registers[instruction.destination] = Emit(instruction.opcode, registers[instruction.left], 0, 0); break;
+            default: registers[instruction.destination] = Emit(instruction.opcode, registers[instruction.left], registers[instruction.right], 0); break;
+        }
+    }
+    __builtin_unreachable();  // Must have "RETURN".
+}
+//---------------------------------------------------------------------------
+uint32_t IRBuilder::Emit(Instruction::Opcode opcode, uint32_t left, uint32_t right, int64_t value) {
+    // Before the "RETURN" instruction the register numbers are the instruction indexes.
+    const bool unary = opcode == Instruction::Opcode::Negate;
+    const bool binary = opcode != Instruction::Opcode::Constant && opcode != Instruction::Opcode::Parameter && !unary;
+    const bool constant_left = (unary || binary) && instructions[left].opcode == Instruction::Opcode::Constant;
+    const bool constant_right = binary && instructions[right].opcode == Instruction::Opcode::Constant;
+    if (constant_left && (unary || constant_right)) {
+        const int64_t l = instructions[left].value;
+        const int64_t r = binary ? instructions[right].value : 0;
+        switch (opcode) {
+            case Instruction::Opcode::Negate: return Emit(Instruction::Opcode::Constant, 0, 0, -1 * l);
+            case Instruction::Opcode::Add: return Emit(Instruction::Opcode::Constant, 0, 0, l + r);
+            case Instruction::Opcode::Sub: return Emit(Instruction::Opcode::Constant, 0, 0, l - r);
+            case Instruction::Opcode::Mul: return Emit(Instruction::Opcode::Constant, 0, 0, l * r);
+            case Instruction::Opcode::Div:
+                // A division by zero is kept, so it fails at runtime.
+                if (r != 0) {
+                    return Emit(Instruction::Opcode::Constant, 0, 0, l / r);
+                }
+                break;
+            default: break;
+        }
+    }
+    if (fused && opcode == Instruction::Opcode::Div && (!constant_right || instructions[right].value == 0)) {
+        divisors.push_back(right);
+    }
+    const Key key{opcode, left, right, value};
+    auto it = values.find(key);
+    if (it != values.end()) {
+        return it->second;
+    }
+    const auto destination = static_cast<uint32_t>(values.size());
+    values.emplace(key, destination);
+    instructions.push_back(Instruction{opcode, destination, left, right, value});
+    return destination;
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(IdentifierPrimaryExpressionAST& node) {
+    auto it = identifiers.find(node.GetName());
+    if (it != identifiers.end()) {
+        result = it->second;
+        return;
+    }
+    // Not assigned yet: a parameter, a constant or a variable with its initial value.
+    auto it_p = std::find(parameters->begin(), parameters->end(), node.GetName());
+    if (it_p != parameters->end()) {
+        result = Emit(Instruction::Opcode::Parameter, 0, 0, it_p - parameters->begin());
+    } else {
+        auto it_st = symbol_table->find(node.GetName());
+        assert(it_st != symbol_table->end());
+        result = Emit(Instruction::Opcode::Constant, 0, 0, it_st->second.GetType() == Symbol::Type::CONSTANT ? it_st->second.GetValue() : 0);
+    }
+    identifiers.emplace(node.GetName(), result);
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(LiteralPrimaryExpressionAST& node) { result = Emit(Instruction::Opcode::Constant, 0, 0, node.GetValue()); }
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(UnaryExpressionAST& node) {
+    node.GetChild()->Accept(*this);
+    if (node.GetUnaryOperatorType() == UnaryExpressionAST::UnaryOperator::NEGATIVE) {
+        result = Emit(Instruction::Opcode::Negate, result, 0, 0);
+    }
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(BinaryExpressionAST& node) {
+    node.GetLeftChild()->Accept(*this);
+    const uint32_t left = result;
+    node.GetRightChild()->Accept(*this);
+    const uint32_t right = result;
+    switch (node.GetBinaryOperatorType()) {
+        case BinaryExpressionAST::BinaryOperator::PLUS: result = Emit(Instruction::Opcode::Add, left, right, 0); break;
+        case BinaryExpressionAST::BinaryOperator::MINUS: result = Emit(Instruction::Opcode::Sub, left, right, 0); break;
+        case BinaryExpressionAST::BinaryOperator::MUL: result = Emit(Instruction::Opcode::Mul, left, right, 0); break;
+        case BinaryExpressionAST::BinaryOperator::DIV: result = Emit(Instruction::Opcode::Div, left, right, 0); break;
+    }
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(AssignmentStatementAST& node) {
+    node.GetExpression()->Accept(*this);
+    identifiers.insert_or_assign(node.GetIdentifier()->GetName(), result);
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(ReturnStatementAST& node) {
+    node.GetExpression()->Accept(*this);
+    if (!fused) {
+        instructions.push_back(Instruction{Instruction::Opcode::Return, 0, result, 0, 0});
+    }
+    returned = true;
+}
+//---------------------------------------------------------------------------
+void IRBuilder::Visit(FunctionAST& node) {
+    // Only the statements up to the first "RETURN" are evaluated.
+    for (auto& child: node.GetChildren()) {
+        child->Accept(*this);
+        if (returned) {
+            break;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
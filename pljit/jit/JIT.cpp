@@ -1,45 +1,560 @@
 #include "jit/JIT.hpp"
 #include "parser/Parser.hpp"
 #include "ast/SemanticAnalyzer.hpp"
-#include "optimization/DeadCodeElimination.hpp"
-#include "optimization/ConstantPropagation.hpp"
+#include "util/AllocationTracker.hpp"
+#include "util/MemoryUsage.hpp"
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <limits>
 #include <mutex>
+#include <utility>
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
 FunctionHandle::FunctionHandle(JIT* jit, size_t index) : jit(jit), index(index) {}
 //---------------------------------------------------------------------------
-FunctionHandle JIT::RegisterFunction(const std::string& code) {
+FunctionHandle JIT::RegisterFunction(const std::string& code, OptimizationLevel level) {
+    return RegisterFunction(code, std::string(PassManager::GetPipelineName(level)));
+}
+//---------------------------------------------------------------------------
+FunctionHandle JIT::RegisterFunction(const std::string& code, std::string pipeline) {
     std::scoped_lock lock(register_mutex);
-    const size_t index = codes.size();
-    assert(flags.size() == codes.size());
-    assert(asts.size() == codes.size());
-    assert(mutexes.size() == codes.size());
-    assert(ecs.size() == codes.size());
-
-    codes.emplace_back(std::make_unique<SourceCodeManagement>(code));
-    mutexes.emplace_back(std::make_unique<std::mutex>());
-    flags.emplace_back(false);
-    asts.emplace_back(nullptr);
-    ecs.emplace_back(nullptr);
-
+    return RegisterFunction(SourceCodeManagement(code), std::move(pipeline), {});
+}
+//---------------------------------------------------------------------------
+bool JIT::AddPipeline(std::string name, std::vector<std::string> passes, size_t max_iterations) {
+    std::scoped_lock lock(register_mutex);
+    return pass_manager.AddPipeline(std::move(name), std::move(passes), max_iterations);
+}
+//---------------------------------------------------------------------------
+FunctionHandle JIT::RegisterFunction(const SourceCodeManagement& code, std::string pipeline, ParameterBinding::Bindings bound_parameters) {
+    const size_t index = functions.size();
+    auto slot = std::make_unique<FunctionSlot>();
+    slot->code = std::make_unique<SourceCodeManagement>(code);
+    slot->bindings = std::move(bound_parameters);
+    slot->pipeline = std::move(pipeline);
+    functions.emplace_back(std::move(slot));
     return FunctionHandle(this, index);
 }
 //---------------------------------------------------------------------------
-int FunctionHandle::Compile() {
-    Parser parser(*jit->codes[index]);
-    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+std::optional<FunctionHandle> JIT::Specialize(const FunctionHandle& function, const ParameterBinding::Bindings& bound_parameters) {
+    assert(function.jit == this);
+    std::optional<FunctionHandle> specialized;
+    {
+        std::scoped_lock lock(register_mutex);
+        const FunctionSlot& slot = *functions[function.index];
+        // A specialization of a specialized function binds both sets of parameters.
+        ParameterBinding::Bindings merged_bindings = slot.bindings;
+        for (auto& [name, value] : bound_parameters) {
+            // A bound parameter is no parameter of the specialized function anymore.
+            if (!merged_bindings.emplace(name, value).second) {
+                std::cerr << "The parameter is already bound: " << name << std::endl;
+                return std::nullopt;
+            }
+        }
+        specialized.emplace(RegisterFunction(*slot.code, slot.pipeline, std::move(merged_bindings)));
+    }
+    if (!specialized->EnsureCompiled()) {
+        return std::nullopt;
+    }
+    return specialized;
+}
+//---------------------------------------------------------------------------
+void JIT::SetTraceRecorder(TraceRecorder* recorder) {
+    trace_recorder.store(recorder);
+}
+//---------------------------------------------------------------------------
+std::vector<FunctionStatistics::Snapshot> JIT::GetStatistics() {
+    std::scoped_lock lock(register_mutex);
+    std::vector<FunctionStatistics::Snapshot> snapshots;
+    snapshots.reserve(functions.size());
+    for (auto& slot : functions) {
+        snapshots.push_back(slot->statistics.GetSnapshot());
+    }
+    return snapshots;
+}
+//---------------------------------------------------------------------------
+JIT::LockStatistics JIT::GetLockStatistics() {
+    LockStatistics statistics;
+    std::scoped_lock lock(register_mutex);
+    statistics.register_mutex = register_mutex.GetStatistics();
+    for (auto& slot : functions) {
+        statistics.function_mutexes += slot->mutex.GetStatistics();
+    }
+    return statistics;
+}
+//---------------------------------------------------------------------------
+void JIT::SetBatchParallelism(size_t threads, size_t morsel_rows) {
+    std::shared_ptr<ThreadPool> previous;
+    {
+        std::scoped_lock lock(register_mutex);
+        batch_threads = threads;
+        batch_morsel_rows = std::max<size_t>(morsel_rows, 1);
+        // Recreated with the new number of threads by the next parallel batch.
+        previous = std::move(thread_pool);
+    }
+    // Joins the workers, unless a running batch still holds the pool.
+    previous.reset();
+}
+//---------------------------------------------------------------------------
+ThreadPool::Statistics JIT::GetThreadPoolStatistics() {
+    std::scoped_lock lock(register_mutex);
+    return thread_pool ? thread_pool->GetStatistics() : ThreadPool::Statistics();
+}
+//---------------------------------------------------------------------------
+void JIT::SetAsyncThreads(size_t threads) {
+    std::vector<std::unique_ptr<Executor>> finished;
+    {
+        std::scoped_lock lock(executor_mutex);
+        async_threads = threads;
+        if (executor) {
+            retired_executors.push_back(std::move(executor));
+        }
+        // An executor cannot join the calling thread, so an executor running it is kept until a later call or the destruction of the JIT.
+        for (auto& retired : retired_executors) {
+            if (!retired->IsWorkerThread()) {
+                finished.push_back(std::move(retired));
+            }
+        }
+        retired_executors.erase(std::remove(retired_executors.begin(), retired_executors.end(), nullptr), retired_executors.end());
+    }
+    // The remaining calls of the previous executors may submit further calls.
+    finished.clear();
+}
+//---------------------------------------------------------------------------
+void JIT::SubmitAsync(Executor::Job job) {
+    std::scoped_lock lock(executor_mutex);
+    if (!executor) {
+        executor = std::make_unique<Executor>(async_threads);
+    }
+    executor->Submit(std::move(job));
+}
+//---------------------------------------------------------------------------
+JIT::MemoryUsage& JIT::MemoryUsage::operator+=(const MemoryUsage& other) {
+    source += other.source;
+    ast += other.ast;
+    symbol_table += other.symbol_table;
+    frame_template += other.frame_template;
+    result_cache += other.result_cache;
+    code += other.code;
+    statistics += other.statistics;
+    return *this;
+}
+//---------------------------------------------------------------------------
+JIT::MemoryUsage JIT::GetMemoryUsage(const FunctionSlot& slot) {
+    MemoryUsage usage;
+    usage.source = slot.code->GetMemoryUsage();
+    // The names of the symbols are views into the source code, so only the tables are counted.
+    usage.symbol_table = sizeof(FunctionSlot) + memory_usage::Of(slot.parameters) + memory_usage::OfHashTable(slot.bindings) + memory_usage::Of(slot.pipeline) + memory_usage::Of(slot.name);
+    for (auto& [name, value] : slot.bindings) {
+        usage.symbol_table += memory_usage::Of(name);
+    }
+    if (slot.ast) { usage.ast = slot.ast->GetMemoryUsage(); }
+    if (slot.ec) { usage.frame_template = slot.ec->GetMemoryUsage(); }
+    if (slot.cache) { usage.result_cache = slot.cache->GetMemoryUsage(); }
+    if (slot.ir) { usage.code = sizeof(IRFunction) + memory_usage::Of(slot.ir->GetInstructions()); }
+    usage.statistics = slot.statistics.GetMemoryUsage();
+    return usage;
+}
+//---------------------------------------------------------------------------
+JIT::MemoryUsage JIT::GetMemoryUsage() {
+    MemoryUsage usage;
+    std::scoped_lock lock(register_mutex);
+    for (auto& slot : functions) {
+        // A concurrent compilation replaces the AST, so the function's mutex is needed.
+        std::scoped_lock lock_fun(slot->mutex);
+        usage += GetMemoryUsage(*slot);
+    }
+    return usage;
+}
+//---------------------------------------------------------------------------
+/// The nanoseconds elapsed since `begin`.
+static uint64_t ElapsedNanoseconds(std::chrono::steady_clock::time_point begin) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count());
+}
+//---------------------------------------------------------------------------
+/// Record the time and the allocations of a compilation phase.
+static void RecordCompilePhase(FunctionStatistics& function_statistics, CompilePhase phase, std::chrono::steady_clock::time_point begin, const AllocationTracker::Scope& allocations) {
+    const AllocationTracker::Statistics statistics = allocations.GetStatistics();
+    function_statistics.RecordCompilePhase(phase, ElapsedNanoseconds(begin), statistics.allocations, statistics.peak_bytes);
+}
+//---------------------------------------------------------------------------
+int FunctionHandle::Compile(JIT::FunctionSlot& slot) {
+    if (!jit->pass_manager.HasPipeline(slot.pipeline)) {
+        std::cerr << "Unknown optimization pipeline: " << slot.pipeline << std::endl;
+        return 4;
+    }
+    TraceRecorder* trace_recorder = jit->trace_recorder.load(std::memory_order_relaxed);
+    const std::string function = trace_recorder ? GetName(slot) : std::string();
+    TraceSpan compile_span(trace_recorder, "compile", "compile", function);
+    auto begin = std::chrono::steady_clock::now();
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree;
+    {
+        // The parser pulls the tokens from the lexer, so lexing is part of this span.
+        TraceSpan span(trace_recorder, "lex+parse", "compile", function);
+        AllocationTracker::Scope allocations;
+        Parser parser(*slot.code);
+        parse_tree = parser.ParseFunctionDefinition();
+        RecordCompilePhase(slot.statistics, CompilePhase::Parse, begin, allocations);
+    }
     if(!parse_tree) { return 1; }
+    begin = std::chrono::steady_clock::now();
     SemanticAnalyzer semantic_analyzer;
-    jit->asts[index] = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
-    if (!jit->asts[index]) { return 2; }
-    jit->ecs[index] = std::make_unique<EvaluationContext>(semantic_analyzer.GetSymbolTable());
-    OptimizeDeadCode opc;
-    opc.Optimize(*jit->asts[index]);
-    ConstantPropagation cp(semantic_analyzer.GetSymbolTable());
-    cp.Optimize(*jit->asts[index]);
+    {
+        TraceSpan span(trace_recorder, "semantic-analysis", "compile", function);
+        AllocationTracker::Scope allocations;
+        slot.ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        RecordCompilePhase(slot.statistics, CompilePhase::SemanticAnalysis, begin, allocations);
+    }
+    if (!slot.ast) { return 2; }
+    begin = std::chrono::steady_clock::now();
+    TraceSpan span(trace_recorder, "optimization", "compile", function);
+    AllocationTracker::Scope allocations;
+    SymbolTable symbol_table = semantic_analyzer.GetSymbolTable();
+    slot.parameters = semantic_analyzer.GetParameters();
+    if (!slot.bindings.empty()) {
+        TraceSpan binding_span(trace_recorder, "parameter-binding", "optimization", function);
+        ParameterBinding pb(symbol_table, slot.bindings);
+        if (!pb.Bind(*slot.ast, slot.parameters)) { return 3; }
+    }
+    slot.ec = std::make_unique<EvaluationContext>(symbol_table);
+    jit->pass_manager.Run(slot.pipeline, *slot.ast, symbol_table, trace_recorder, function);
+    slot.constant = slot.ast->GetConstantReturnValue();
+    {
+        TraceSpan lowering_span(trace_recorder, "ir-lowering", "optimization", function);
+        IRBuilder builder(symbol_table, slot.parameters);
+        slot.ir = std::make_unique<IRFunction>(builder.Build(*slot.ast));
+    }
+    RecordCompilePhase(slot.statistics, CompilePhase::Optimization, begin, allocations);
     return 0;
 }
+//---------------------------------------------------------------------------
+bool FunctionHandle::CompileIfNeeded(JIT::FunctionSlot& slot) {
+    if (!slot.compiled) {
+        if (this->Compile(slot) != 0) {
+            return false;
+        }
+        slot.compiled = true;
+        slot.statistics.SetTier(slot.constant ? Tier::Constant : Tier::Interpreted);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::EnsureCompiled() {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    JIT::FunctionSlot& slot = *jit->functions[index];
+    std::scoped_lock lock_fun(slot.mutex);
+    return CompileIfNeeded(slot);
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::EnableResultCache(size_t capacity) {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    JIT::FunctionSlot& slot = *jit->functions[index];
+    std::scoped_lock lock_fun(slot.mutex);
+    if (!CompileIfNeeded(slot)) {
+        return false;
+    }
+    // A running call may use the current cache, so it is never replaced.
+    if (!slot.cache) {
+        slot.cache = std::make_unique<ResultCache>(slot.parameters.size(), capacity);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+ResultCache::Statistics FunctionHandle::GetResultCacheStatistics() {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    const auto& cache = jit->functions[index]->cache;
+    return cache ? cache->GetStatistics() : ResultCache::Statistics();
+}
+//---------------------------------------------------------------------------
+void FunctionHandle::SetName(std::string name) {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    jit->functions[index]->name = std::move(name);
+}
+//---------------------------------------------------------------------------
+std::string FunctionHandle::GetName(const JIT::FunctionSlot& slot) const {
+    return slot.name.empty() ? "pljit_function_" + std::to_string(index) : slot.name;
+}
+//---------------------------------------------------------------------------
+std::string FunctionHandle::GetName() {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    return GetName(*jit->functions[index]);
+}
+//---------------------------------------------------------------------------
+FunctionStatistics::Snapshot FunctionHandle::GetStatistics() {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    return jit->functions[index]->statistics.GetSnapshot();
+}
+//---------------------------------------------------------------------------
+JIT::MemoryUsage FunctionHandle::GetMemoryUsage() {
+    std::scoped_lock lock_reg(jit->register_mutex);
+    JIT::FunctionSlot& slot = *jit->functions[index];
+    std::scoped_lock lock_fun(slot.mutex);
+    return JIT::GetMemoryUsage(slot);
+}
+//---------------------------------------------------------------------------
+std::optional<size_t> FunctionHandle::GetNumberOfParameters() {
+    if (!EnsureCompiled()) {
+        return std::nullopt;
+    }
+    std::scoped_lock lock_reg(jit->register_mutex);
+    return jit->functions[index]->parameters.size();
+}
+//---------------------------------------------------------------------------
+template <typename Evaluate>
+bool FunctionHandle::RunBatch(size_t number_of_rows, const Evaluate& evaluate, const std::vector<bool>* scalar_parameters) {
+    TraceRecorder* trace_recorder = jit->trace_recorder.load(std::memory_order_relaxed);
+    JIT::FunctionSlot* slot;
+    // The span keeps a view of the name, so the name outlives it.
+    std::string function;
+    std::optional<TraceSpan> span;
+    std::shared_ptr<ThreadPool> thread_pool;
+    size_t morsel_rows;
+    {
+        std::scoped_lock lock_reg(jit->register_mutex);
+        slot = jit->functions[index].get();
+        if (trace_recorder) {
+            function = GetName(*slot);
+            span.emplace(trace_recorder, function, "batch");
+        }
+        morsel_rows = jit->batch_morsel_rows;
+        if (number_of_rows > morsel_rows && jit->batch_threads != 1) {
+            if (!jit->thread_pool) {
+                jit->thread_pool = std::make_shared<ThreadPool>(jit->batch_threads);
+            }
+            thread_pool = jit->thread_pool;
+        }
+        std::scoped_lock lock_fun(slot->mutex);
+        if (!CompileIfNeeded(*slot)) {
+            return false;
+        }
+    }
+    if (scalar_parameters && scalar_parameters->size() != slot->parameters.size()) {
+        std::cerr << "Wrong number of scalar parameter flags: expected " << slot->parameters.size() << ", got " << scalar_parameters->size() << std::endl;
+        return false;
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    size_t number_of_errors;
+    if (!thread_pool || thread_pool->GetNumberOfThreads() == 1) {
+        number_of_errors = evaluate(*slot, size_t(0), number_of_rows);
+    } else {
+        std::atomic<size_t> morsel_errors = 0;
+        const size_t number_of_morsels = (number_of_rows + morsel_rows - 1) / morsel_rows;
+        thread_pool->ParallelFor(number_of_morsels, [&](size_t morsel, size_t /*thread*/) {
+            const size_t morsel_begin = morsel * morsel_rows;
+            morsel_errors.fetch_add(evaluate(*slot, morsel_begin, std::min(morsel_rows, number_of_rows - morsel_begin)), std::memory_order_relaxed);
+        });
+        number_of_errors = morsel_errors.load(std::memory_order_relaxed);
+    }
+    slot->statistics.RecordBatch(number_of_rows, ElapsedNanoseconds(begin), number_of_errors);
+    return true;
+}
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Get the columns of the rows starting at `begin`. A scalar column is the same for all rows.
+std::vector<const int64_t*> OffsetColumns(const int64_t* const* columns, size_t number_of_columns, size_t begin, const std::vector<bool>* scalar_parameters) {
+    std::vector<const int64_t*> result(columns, columns + number_of_columns);
+    for (size_t c = 0; c < number_of_columns; c++) {
+        if (!scalar_parameters || !(*scalar_parameters)[c]) {
+            result[c] += begin;
+        }
+    }
+    return result;
+}
+//---------------------------------------------------------------------------
+/// Move the selection vectors of the morsels, each at the position of its first row, to the front, and make their indexes absolute.
+/// @return The number of selected rows.
+size_t CompactSelections(std::vector<std::pair<size_t, size_t>>& morsels, uint32_t* selection) {
+    std::sort(morsels.begin(), morsels.end());
+    size_t number_of_selected = 0;
+    for (auto [begin, count] : morsels) {
+        // The target is never behind the source, so the copy can run forwards.
+        for (size_t i = 0; i < count; i++) {
+            selection[number_of_selected + i] = selection[begin + i] + static_cast<uint32_t>(begin);
+        }
+        number_of_selected += count;
+    }
+    return number_of_selected;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+bool FunctionHandle::CallBatch(const int64_t* arguments, size_t number_of_rows, int64_t* results, uint8_t* errors) {
+    return RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        if (slot.constant) {
+            std::fill(results + begin, results + begin + rows, *slot.constant);
+            std::fill(errors + begin, errors + begin + rows, 0);
+            return 0;
+        }
+        return slot.ir->EvaluateBatch(arguments + begin * slot.parameters.size(), rows, results + begin, errors + begin);
+    });
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::CallColumns(const int64_t* const* columns, size_t number_of_rows, int64_t* results, uint8_t* errors, const std::vector<bool>* scalar_parameters) {
+    return RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        if (slot.constant) {
+            std::fill(results + begin, results + begin + rows, *slot.constant);
+            std::fill(errors + begin, errors + begin + rows, 0);
+            return 0;
+        }
+        const auto morsel_columns = OffsetColumns(columns, slot.parameters.size(), begin, scalar_parameters);
+        return slot.ir->EvaluateColumns(morsel_columns.data(), rows, results + begin, errors + begin, scalar_parameters);
+    }, scalar_parameters);
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::Aggregate(const int64_t* arguments, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates) {
+    // The IR of a constant function is a constant, too.
+    std::mutex merge_mutex;
+    return RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        Aggregates morsel_aggregates;
+        slot.ir->AggregateBatch(arguments + begin * slot.parameters.size(), rows, aggregation, morsel_aggregates);
+        std::scoped_lock lock(merge_mutex);
+        aggregates.Merge(morsel_aggregates);
+        return morsel_aggregates.errors;
+    });
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::AggregateColumns(const int64_t* const* columns, size_t number_of_rows, const Aggregation& aggregation, Aggregates& aggregates,
+                                      const std::vector<bool>* scalar_parameters) {
+    std::mutex merge_mutex;
+    return RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        Aggregates morsel_aggregates;
+        const auto morsel_columns = OffsetColumns(columns, slot.parameters.size(), begin, scalar_parameters);
+        slot.ir->AggregateColumns(morsel_columns.data(), rows, aggregation, morsel_aggregates, scalar_parameters);
+        std::scoped_lock lock(merge_mutex);
+        aggregates.Merge(morsel_aggregates);
+        return morsel_aggregates.errors;
+    }, scalar_parameters);
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::Select(const int64_t* arguments, size_t number_of_rows, uint32_t* selection, size_t& number_of_selected) {
+    if (number_of_rows > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "Too many rows for a selection vector: " << number_of_rows << std::endl;
+        return false;
+    }
+    // The first row and the number of selected rows of every morsel.
+    std::vector<std::pair<size_t, size_t>> morsels;
+    std::mutex morsels_mutex;
+    const bool success = RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        size_t number_of_errors;
+        const size_t count = slot.ir->SelectBatch(arguments + begin * slot.parameters.size(), rows, selection + begin, number_of_errors);
+        std::scoped_lock lock(morsels_mutex);
+        morsels.emplace_back(begin, count);
+        return number_of_errors;
+    });
+    if (success) {
+        number_of_selected = CompactSelections(morsels, selection);
+    }
+    return success;
+}
+//---------------------------------------------------------------------------
+bool FunctionHandle::SelectColumns(const int64_t* const* columns, size_t number_of_rows, uint32_t* selection, size_t& number_of_selected, const std::vector<bool>* scalar_parameters) {
+    if (number_of_rows > std::numeric_limits<uint32_t>::max()) {
+        std::cerr << "Too many rows for a selection vector: " << number_of_rows << std::endl;
+        return false;
+    }
+    std::vector<std::pair<size_t, size_t>> morsels;
+    std::mutex morsels_mutex;
+    const bool success = RunBatch(number_of_rows, [&](const JIT::FunctionSlot& slot, size_t begin, size_t rows) -> size_t {
+        size_t number_of_errors;
+        const auto morsel_columns = OffsetColumns(columns, slot.parameters.size(), begin, scalar_parameters);
+        const size_t count = slot.ir->SelectColumns(morsel_columns.data(), rows, selection + begin, number_of_errors, scalar_parameters);
+        std::scoped_lock lock(morsels_mutex);
+        morsels.emplace_back(begin, count);
+        return number_of_errors;
+    }, scalar_parameters);
+    if (success) {
+        number_of_selected = CompactSelections(morsels, selection);
+    }
+    return success;
+}
+//---------------------------------------------------------------------------
+std::future<std::optional<int64_t>> FunctionHandle::CallAsync(std::vector<int64_t> arguments) {
+    // A job has to be copyable, so the promise is shared.
+    auto promise = std::make_shared<std::promise<std::optional<int64_t>>>();
+    auto future = promise->get_future();
+    CallAsync(std::move(arguments), [promise](std::optional<int64_t> value) { promise->set_value(value); });
+    return future;
+}
+//---------------------------------------------------------------------------
+void FunctionHandle::CallAsync(std::vector<int64_t> arguments, std::function<void(std::optional<int64_t>)> callback) {
+    jit->SubmitAsync([function = *this, arguments = std::move(arguments), callback = std::move(callback)]() mutable {
+        callback(function.Call(arguments.data(), arguments.size()));
+    });
+}
+//---------------------------------------------------------------------------
+std::future<bool> FunctionHandle::CompileAsync() {
+    auto promise = std::make_shared<std::promise<bool>>();
+    auto future = promise->get_future();
+    jit->SubmitAsync([function = *this, promise]() mutable { promise->set_value(function.EnsureCompiled()); });
+    return future;
+}
+//---------------------------------------------------------------------------
+std::optional<int64_t> FunctionHandle::Call(const int64_t* arguments, size_t number_of_arguments) {
+    /// Check.
+    TraceRecorder* trace_recorder = jit->trace_recorder.load(std::memory_order_relaxed);
+    JIT::FunctionSlot* slot;
+    ResultCache* cache;
+    std::string function;
+    std::optional<TraceSpan> span;
+    {
+        std::scoped_lock lock_reg(jit->register_mutex);
+        slot = jit->functions[index].get();
+        if (trace_recorder) {
+            function = GetName(*slot);
+            span.emplace(trace_recorder, function, "call");
+        }
+        std::scoped_lock lock_fun(slot->mutex);
+        if (!CompileIfNeeded(*slot)) {
+            return {};
+        }
+        cache = slot->cache.get();
+    }
+    // The compiled state is never changed again, so it is read without the locks.
+    const std::vector<std::string_view>& parameter_names = slot->parameters;
+    if (number_of_arguments != parameter_names.size()) {
+        std::cerr << "Wrong number of arguments: expected " << parameter_names.size() << ", got " << number_of_arguments << std::endl;
+        return {};
+    }
+    const auto begin = std::chrono::steady_clock::now();
+
+    /// A constant function: neither the evaluation context nor the arguments are needed.
+    if (slot->constant) {
+        slot->statistics.RecordCall(ElapsedNanoseconds(begin), false);
+        return slot->constant;
+    }
+
+    /// Look up the result cache.
+    std::optional<int64_t> cached_value;
+    if (cache && cache->Lookup(arguments, cached_value)) {
+        slot->statistics.RecordCall(ElapsedNanoseconds(begin), !cached_value);
+        if (!cached_value) {
+            std::cerr << "Division by zero error" << std::endl;
+        }
+        return cached_value;
+    }
+
+    /// Set parameter's values.
+    EvaluationContext ec = *slot->ec;
+    for (size_t i = 0; i < number_of_arguments; i++) {
+        auto it = ec.GetValueTable().find(parameter_names[i]);
+        assert(it != ec.GetValueTable().end());
+        it->second.SetValue(arguments[i]);
+    }
+
+    /// Run the function.
+    const int64_t return_value = slot->ast->Evaluate(ec);
+    slot->statistics.RecordCall(ElapsedNanoseconds(begin), ec.GetDivisionByZero());
+    if (ec.GetDivisionByZero()) {
+        if (cache) { cache->Insert(arguments, std::nullopt); }
+        std::cerr << "Division by zero error" << std::endl;
+        return {};
+    }
+    if (cache) { cache->Insert(arguments, return_value); }
+    return {return_value};
+}
+//---------------------------------------------------------------------------
 } // namespace pljit
-//---------------------------------------------------------------------------
\ No newline at end of file
+//---------------------------------------------------------------------------
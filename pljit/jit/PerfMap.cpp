@@ -0,0 +1,139 @@
+//---------------------------------------------------------------------------
+#include "jit/PerfMap.hpp"
+#include <ctime>
+#include <elf.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The jitdump file header, see `tools/perf/Documentation/jitdump-specification.txt` of the kernel.
+struct JitDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+//---------------------------------------------------------------------------
+/// The jitdump JIT_CODE_LOAD record, followed by the name and the code.
+struct JitDumpCodeLoad {
+    uint32_t id;
+    uint32_t total_size;
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_address;
+    uint64_t code_size;
+    uint64_t code_index;
+};
+//---------------------------------------------------------------------------
+/// The jitdump magic "JiTD".
+constexpr uint32_t jitdump_magic = 0x4A695444;
+/// The id of the JIT_CODE_LOAD record.
+constexpr uint32_t jitdump_code_load = 0;
+//---------------------------------------------------------------------------
+/// The timestamp of a jitdump record, `perf record -k mono` uses the same clock.
+uint64_t Timestamp() {
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000 + static_cast<uint64_t>(ts.tv_nsec);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+PerfMap::PerfMap(Format format) : PerfMap(format, GetDefaultPath(format)) {}
+//---------------------------------------------------------------------------
+PerfMap::PerfMap(Format format, std::string path) : format(format), path(std::move(path)) {
+    file = fopen(this->path.c_str(), format == Format::Map ? "w" : "w+");
+    if (!file) {
+        std::cerr << "Opening the perf map failed: " << this->path << std::endl;
+        return;
+    }
+    if (format == Format::JitDump) {
+        WriteJitDumpHeader();
+        // perf record only picks up jitdump files mapped executable by the process.
+        const long page_size = sysconf(_SC_PAGESIZE);
+        marker = mmap(nullptr, page_size, PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(file), 0);
+        if (marker == MAP_FAILED) {
+            marker = nullptr;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+PerfMap::~PerfMap() {
+    if (marker) {
+        munmap(marker, sysconf(_SC_PAGESIZE));
+    }
+    if (file) {
+        fclose(file);
+    }
+}
+//---------------------------------------------------------------------------
+std::string PerfMap::GetDefaultPath(Format format) {
+    const std::string pid = std::to_string(getpid());
+    return format == Format::Map ? "/tmp/perf-" + pid + ".map" : "/tmp/jit-" + pid + ".dump";
+}
+//---------------------------------------------------------------------------
+bool PerfMap::IsOpen() const {
+    return file != nullptr;
+}
+//---------------------------------------------------------------------------
+const std::string& PerfMap::GetPath() const {
+    return path;
+}
+//---------------------------------------------------------------------------
+void PerfMap::WriteJitDumpHeader() {
+    JitDumpHeader header{};
+    header.magic = jitdump_magic;
+    header.version = 1;
+    header.total_size = sizeof(JitDumpHeader);
+#if defined(__x86_64__)
+    header.elf_mach = EM_X86_64;
+#elif defined(__aarch64__)
+    header.elf_mach = EM_AARCH64;
+#endif
+    header.pid = static_cast<uint32_t>(getpid());
+    header.timestamp = Timestamp();
+    fwrite(&header, sizeof(header), 1, file);
+    fflush(file);
+}
+//---------------------------------------------------------------------------
+void PerfMap::Register(const void* code, size_t size, std::string_view name) {
+    std::scoped_lock lock(mutex);
+    if (!file) {
+        return;
+    }
+    const auto address = reinterpret_cast<uintptr_t>(code);
+    if (format == Format::Map) {
+        fprintf(file, "%lx %zx %.*s\n", static_cast<unsigned long>(address), size, static_cast<int>(name.size()), name.data());
+    } else {
+        JitDumpCodeLoad record{};
+        record.id = jitdump_code_load;
+        record.total_size = static_cast<uint32_t>(sizeof(JitDumpCodeLoad) + name.size() + 1 + size);
+        record.timestamp = Timestamp();
+        record.pid = static_cast<uint32_t>(getpid());
+        record.tid = static_cast<uint32_t>(syscall(SYS_gettid));
+        record.vma = address;
+        record.code_address = address;
+        record.code_size = size;
+        record.code_index = code_index++;
+        fwrite(&record, sizeof(record), 1, file);
+        fwrite(name.data(), 1, name.size(), file);
+        fputc('\0', file);
+        fwrite(code, 1, size, file);
+    }
+    // perf may read the file while the process is running.
+    fflush(file);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//---------------------------------------------------------------------------
+#include "jit/RegisterAllocator.hpp"
+#include <algorithm>
+#include <cassert>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+LinearScanRegisterAllocator::LinearScanRegisterAllocator(uint32_t number_of_registers) : number_of_registers(number_of_registers) {}
+//---------------------------------------------------------------------------
+std::vector<LinearScanRegisterAllocator::Interval> LinearScanRegisterAllocator::ComputeLiveIntervals(const IRFunction& function) {
+    std::vector<Interval> intervals(function.GetNumberOfRegisters());
+    const auto& instructions = function.GetInstructions();
+    for (uint32_t i = 0; i < instructions.size(); i++) {
+        const Instruction& instruction = instructions[i];
+        switch (instruction.opcode) {
+            case Instruction::Opcode::Constant:
+            case Instruction::Opcode::Parameter:
+                break;
+            case Instruction::Opcode::Negate:
+            case Instruction::Opcode::Return:
+                intervals[instruction.left].end = i;
+                break;
+            case Instruction::Opcode::Add:
+            case Instruction::Opcode::Sub:
+            case Instruction::Opcode::Mul:
+            case Instruction::Opcode::Div:
+                intervals[instruction.left].end = i;
+                intervals[instruction.right].end = i;
+                break;
+        }
+        if (instruction.opcode != Instruction::Opcode::Return) {
+            // The registers are defined in order: the intervals are sorted by their start.
+            intervals[instruction.destination] = Interval{i, i};
+        }
+    }
+    return intervals;
+}
+//---------------------------------------------------------------------------
+LinearScanRegisterAllocator::Allocation LinearScanRegisterAllocator::Allocate(const IRFunction& function) const {
+    const std::vector<Interval> intervals = ComputeLiveIntervals(function);
+    Allocation allocation;
+    allocation.locations.resize(intervals.size());
+
+    // The active registers, sorted by the end of their interval.
+    std::vector<uint32_t> active;
+    std::vector<uint32_t> free_registers;
+    for (uint32_t r = number_of_registers; r-- > 0;) {
+        free_registers.push_back(r);
+    }
+    // The free spill slots with the end of their last interval.
+    std::vector<std::pair<uint32_t, uint32_t>> free_spill_slots;
+    // The spilled registers, which release their slot when they expire.
+    std::vector<uint32_t> spilled;
+
+    auto insert_active = [&](uint32_t virtual_register) {
+        auto position = std::upper_bound(active.begin(), active.end(), virtual_register, [&](uint32_t a, uint32_t b) { return intervals[a].end < intervals[b].end; });
+        active.insert(position, virtual_register);
+    };
+    // A slot can be reused by an interval starting after the previous one ended.
+    auto new_spill_slot = [&](uint32_t start) {
+        for (auto it = free_spill_slots.begin(); it != free_spill_slots.end(); ++it) {
+            if (it->second <= start) {
+                const uint32_t slot = it->first;
+                free_spill_slots.erase(it);
+                return slot;
+            }
+        }
+        return allocation.number_of_spill_slots++;
+    };
+
+    for (uint32_t current = 0; current < intervals.size(); current++) {
+        const Interval& interval = intervals[current];
+        // Expire the intervals ending at or before the start of the current one.
+        while (!active.empty() && intervals[active.front()].end <= interval.start) {
+            free_registers.push_back(allocation.locations[active.front()].index);
+            active.erase(active.begin());
+        }
+        spilled.erase(std::remove_if(spilled.begin(), spilled.end(), [&](uint32_t virtual_register) {
+            if (intervals[virtual_register].end <= interval.start) {
+                free_spill_slots.emplace_back(allocation.locations[virtual_register].index, intervals[virtual_register].end);
+                return true;
+            }
+            return false;
+        }), spilled.end());
+
+        if (!free_registers.empty()) {
+            const uint32_t r = free_registers.back();
+            free_registers.pop_back();
+            allocation.locations[current] = Location{Location::Kind::Register, r};
+            allocation.number_of_used_registers = std::max(allocation.number_of_used_registers, r + 1);
+            insert_active(current);
+            continue;
+        }
+        // No free register: spill the interval ending last.
+        if (!active.empty() && intervals[active.back()].end > interval.end) {
+            const uint32_t victim = active.back();
+            active.pop_back();
+            allocation.locations[current] = allocation.locations[victim];
+            allocation.locations[victim] = Location{Location::Kind::Spill, new_spill_slot(intervals[victim].start)};
+            spilled.push_back(victim);
+            insert_active(current);
+        } else {
+            allocation.locations[current] = Location{Location::Kind::Spill, new_spill_slot(interval.start)};
+            spilled.push_back(current);
+        }
+    }
+    return allocation;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
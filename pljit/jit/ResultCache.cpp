@@ -0,0 +1,110 @@
+//---------------------------------------------------------------------------
+#include "jit/ResultCache.hpp"
+#include "util/MemoryUsage.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+ResultCache::ResultCache(size_t number_of_arguments, size_t capacity)
+ : number_of_arguments(number_of_arguments), slots_per_stripe(std::max<size_t>(capacity / number_of_stripes, number_of_probes)) {
+    for (auto& stripe : stripes) {
+        stripe.slots.resize(slots_per_stripe);
+        stripe.arguments.resize(slots_per_stripe * number_of_arguments);
+    }
+}
+//---------------------------------------------------------------------------
+uint64_t ResultCache::Hash(const int64_t* arguments) const {
+    uint64_t hash = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < number_of_arguments; i++) {
+        // The finalizer of MurmurHash3 for each argument.
+        uint64_t k = static_cast<uint64_t>(arguments[i]) + hash;
+        k = (k ^ (k >> 33)) * 0xFF51AFD7ED558CCDull;
+        k = (k ^ (k >> 33)) * 0xC4CEB9FE1A85EC53ull;
+        hash = k ^ (k >> 33);
+    }
+    return hash | 1;
+}
+//---------------------------------------------------------------------------
+bool ResultCache::Matches(const Stripe& stripe, size_t slot, uint64_t hash, const int64_t* arguments) const {
+    return stripe.slots[slot].hash == hash &&
+        std::memcmp(&stripe.arguments[slot * number_of_arguments], arguments, number_of_arguments * sizeof(int64_t)) == 0;
+}
+//---------------------------------------------------------------------------
+bool ResultCache::Lookup(const int64_t* arguments, std::optional<int64_t>& result) {
+    if (!IsEnabled()) { return false; }
+    const uint64_t hash = Hash(arguments);
+    // The low bits select the stripe, the remaining bits the slot.
+    Stripe& stripe = stripes[hash % number_of_stripes];
+    const size_t home = (hash / number_of_stripes) % slots_per_stripe;
+    bool hit = false;
+    {
+        std::scoped_lock lock(stripe.mutex);
+        for (size_t probe = 0; probe < number_of_probes; probe++) {
+            const size_t slot = (home + probe) % slots_per_stripe;
+            if (Matches(stripe, slot, hash, arguments)) {
+                result = stripe.slots[slot].result;
+                hit = true;
+                break;
+            }
+        }
+    }
+    Account(hit);
+    return hit;
+}
+//---------------------------------------------------------------------------
+void ResultCache::Insert(const int64_t* arguments, std::optional<int64_t> result) {
+    if (!IsEnabled()) { return; }
+    const uint64_t hash = Hash(arguments);
+    Stripe& stripe = stripes[hash % number_of_stripes];
+    const size_t home = (hash / number_of_stripes) % slots_per_stripe;
+    std::scoped_lock lock(stripe.mutex);
+    // Take the first free slot or one that already holds the arguments (a concurrent insert), otherwise evict the home slot.
+    size_t victim = home;
+    for (size_t probe = 0; probe < number_of_probes; probe++) {
+        const size_t slot = (home + probe) % slots_per_stripe;
+        if (stripe.slots[slot].hash == 0 || Matches(stripe, slot, hash, arguments)) {
+            victim = slot;
+            break;
+        }
+    }
+    stripe.slots[victim].hash = hash;
+    stripe.slots[victim].result = result;
+    std::copy(arguments, arguments + number_of_arguments, &stripe.arguments[victim * number_of_arguments]);
+}
+//---------------------------------------------------------------------------
+void ResultCache::Account(bool hit) {
+    (hit ? hits : misses).fetch_add(1, std::memory_order_relaxed);
+    const uint64_t window_hit_count = hit ? window_hits.fetch_add(1, std::memory_order_relaxed) + 1 : window_hits.load(std::memory_order_relaxed);
+    if (window_lookups.fetch_add(1, std::memory_order_relaxed) + 1 == window_size) {
+        // The end of the window: does the cache still pay off?
+        if (window_hit_count * 100 < window_size * min_hit_rate_percent) {
+            enabled.store(false, std::memory_order_relaxed);
+        }
+        window_hits.store(0, std::memory_order_relaxed);
+        window_lookups.store(0, std::memory_order_relaxed);
+    }
+}
+//---------------------------------------------------------------------------
+bool ResultCache::IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+//---------------------------------------------------------------------------
+ResultCache::Statistics ResultCache::GetStatistics() const {
+    Statistics statistics;
+    statistics.hits = hits.load(std::memory_order_relaxed);
+    statistics.misses = misses.load(std::memory_order_relaxed);
+    statistics.enabled = IsEnabled();
+    return statistics;
+}
+//---------------------------------------------------------------------------
+size_t ResultCache::GetMemoryUsage() const {
+    size_t bytes = sizeof(ResultCache);
+    for (auto& stripe : stripes) {
+        // The slots and arguments are never resized, so reading their sizes needs no lock.
+        bytes += memory_usage::Of(stripe.slots) + memory_usage::Of(stripe.arguments);
+    }
+    return bytes;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
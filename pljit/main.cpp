@@ -1,8 +1,402 @@
+#include "ast/ASTNodeVisitorDot.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "jit/BatchServer.hpp"
+#include "jit/ColumnEvaluator.hpp"
+#include "jit/IR.hpp"
+#include "jit/JIT.hpp"
+#include "parser/Parser.hpp"
+#include "parser/ParseTreeNodeVisitorDot.hpp"
+#include "util/AllocationTracker.hpp"
+#include "util/Trace.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <vector>
 //---------------------------------------------------------------------------
 using namespace std;
+using namespace pljit;
 //---------------------------------------------------------------------------
-int main() {
-    cout << "use for experiments" << endl;
+namespace {
+//---------------------------------------------------------------------------
+/// The command line options.
+struct Options {
+    /// The source files, "-" for the standard input. One without `--serve`.
+    vector<string> paths;
+    /// The arguments of the call.
+    vector<int64_t> arguments;
+    /// The optimization level.
+    OptimizationLevel level = OptimizationLevel::O2;
+    /// The dumps.
+    bool dump_parse_tree = false;
+    bool dump_ast = false;
+    bool dump_optimized_ast = false;
+    bool dump_ir = false;
+    /// The number of timed calls, 0 for a single call.
+    uint64_t bench_calls = 0;
+    /// If the statistics are printed.
+    bool stats = false;
+    /// The trace file, empty for no tracing.
+    string trace_path;
+    /// If the rows of the standard input are evaluated.
+    bool serve = false;
+    /// The options of the server.
+    BatchServer::Options server_options;
+    /// The parameter column files, empty for no column evaluation.
+    vector<string> column_paths;
+    /// The result column file.
+    string output_path;
+    /// The error column file, empty for none.
+    string errors_path;
+    /// The options of the column evaluation.
+    ColumnEvaluator::Options column_options;
+    /// If the results of the column evaluation are aggregated instead of written.
+    bool aggregate = false;
+    /// The aggregation.
+    Aggregation aggregation;
+};
+//---------------------------------------------------------------------------
+/// Print the usage.
+void PrintUsage(const char* program) {
+    cerr << "usage: " << program << " [options] <file.pl0 | -> [arguments...]" << endl
+         << "       " << program << " --serve [--binary] [--batch <rows>] [options] <file.pl0>..." << endl
+         << "       " << program << " --columns <a.col,b.col,...> --output <result.col> [--errors <errors.col>] [--threads <n>] [options] <file.pl0>" << endl
+         << "       " << program << " --columns <a.col,b.col,...> --aggregate [--histogram <lower,width,buckets>] [--threads <n>] [options] <file.pl0>" << endl
+         << "  -O0, -O1, -O2, -O3        optimization level (default: -O2)" << endl
+         << "  --dump-parse-tree         print the parse tree in the DOT format" << endl
+         << "  --dump-ast                print the AST in the DOT format" << endl
+         << "  --dump-optimized-ast      print the optimized AST in the DOT format" << endl
+         << "  --dump-ir                 print the IR of the optimized AST" << endl
+         << "  --bench <n>               call the function n times and print the latency" << endl
+         << "  --stats                   print the compilation phases, the calls and the memory usage" << endl
+         << "  --trace <path>            write the compilation and the calls in the Chrome trace event format" << endl
+         << "  --serve                   evaluate all functions for every row of the standard input" << endl
+         << "  --binary                  rows are records of 64 bit integers instead of text lines" << endl
+         << "  --batch <rows>            the number of rows evaluated at once (default: 4096)" << endl
+         << "  --columns <paths>         evaluate the function for the comma-separated parameter columns of little-endian 64 bit integers" << endl
+         << "  --output <path>           the result column" << endl
+         << "  --errors <path>           a column of a byte per row, 1 for a division by zero" << endl
+         << "  --threads <n>             the number of threads of the column evaluation (default: hardware threads)" << endl
+         << "  --aggregate               print the count, sum, minimum and maximum of the results instead of writing them" << endl
+         << "  --histogram <l,w,n>       also print a histogram of n buckets of width w starting at l" << endl;
+}
+//---------------------------------------------------------------------------
+/// Parse an integer.
+/// @return True for success, false for failure (not an integer or out of range).
+bool ParseInteger(const char* text, int64_t& value) {
+    char* end = nullptr;
+    errno = 0;
+    value = strtoll(text, &end, 10);
+    return *text && !*end && errno == 0;
+}
+//---------------------------------------------------------------------------
+/// Parse the command line. Arguments after the source file are the function's arguments, so negative numbers are no options.
+/// @return True for success, false for failure.
+bool ParseOptions(int argc, char* argv[], Options& options) {
+    int i = 1;
+    for (; i < argc && (options.serve || options.paths.empty()); i++) {
+        const bool has_value = i + 1 < argc;
+        if (!strcmp(argv[i], "-O0")) {
+            options.level = OptimizationLevel::O0;
+        } else if (!strcmp(argv[i], "-O1")) {
+            options.level = OptimizationLevel::O1;
+        } else if (!strcmp(argv[i], "-O2")) {
+            options.level = OptimizationLevel::O2;
+        } else if (!strcmp(argv[i], "-O3")) {
+            options.level = OptimizationLevel::O3;
+        } else if (!strcmp(argv[i], "--dump-parse-tree")) {
+            options.dump_parse_tree = true;
+        } else if (!strcmp(argv[i], "--dump-ast")) {
+            options.dump_ast = true;
+        } else if (!strcmp(argv[i], "--dump-optimized-ast")) {
+            options.dump_optimized_ast = true;
+        } else if (!strcmp(argv[i], "--dump-ir")) {
+            options.dump_ir = true;
+        } else if (!strcmp(argv[i], "--bench") && has_value) {
+            int64_t calls;
+            if (!ParseInteger(argv[++i], calls) || calls <= 0) {
+                cerr << "Invalid number of calls: " << argv[i] << endl;
+                return false;
+            }
+            options.bench_calls = static_cast<uint64_t>(calls);
+        } else if (!strcmp(argv[i], "--stats")) {
+            options.stats = true;
+        } else if (!strcmp(argv[i], "--trace") && has_value) {
+            options.trace_path = argv[++i];
+        } else if (!strcmp(argv[i], "--serve")) {
+            options.serve = true;
+        } else if (!strcmp(argv[i], "--binary")) {
+            options.server_options.format = BatchServer::Format::Binary;
+        } else if (!strcmp(argv[i], "--batch") && has_value) {
+            int64_t rows;
+            if (!ParseInteger(argv[++i], rows) || rows <= 0) {
+                cerr << "Invalid batch size: " << argv[i] << endl;
+                return false;
+            }
+            options.server_options.batch_size = static_cast<size_t>(rows);
+        } else if (!strcmp(argv[i], "--columns") && has_value) {
+            stringstream paths(argv[++i]);
+            for (string path; getline(paths, path, ',');) {
+                options.column_paths.push_back(path);
+            }
+        } else if (!strcmp(argv[i], "--output") && has_value) {
+            options.output_path = argv[++i];
+        } else if (!strcmp(argv[i], "--errors") && has_value) {
+            options.errors_path = argv[++i];
+        } else if (!strcmp(argv[i], "--threads") && has_value) {
+            int64_t threads;
+            if (!ParseInteger(argv[++i], threads) || threads <= 0) {
+                cerr << "Invalid number of threads: " << argv[i] << endl;
+                return false;
+            }
+            options.column_options.threads = static_cast<size_t>(threads);
+        } else if (!strcmp(argv[i], "--aggregate")) {
+            options.aggregate = true;
+        } else if (!strcmp(argv[i], "--histogram") && has_value) {
+            stringstream values(argv[++i]);
+            int64_t histogram[3];
+            size_t count = 0;
+            for (string value; count < 3 && getline(values, value, ',') && ParseInteger(value.c_str(), histogram[count]); count++) {}
+            if (count != 3 || !values.eof() || histogram[1] <= 0 || histogram[2] <= 0) {
+                cerr << "Invalid histogram: " << argv[i] << endl;
+                return false;
+            }
+            options.aggregation.histogram_lower = histogram[0];
+            options.aggregation.histogram_width = static_cast<uint64_t>(histogram[1]);
+            options.aggregation.histogram_buckets = static_cast<size_t>(histogram[2]);
+        } else if (argv[i][0] != '-' || !strcmp(argv[i], "-")) {
+            options.paths.emplace_back(argv[i]);
+        } else {
+            cerr << "Unknown option: " << argv[i] << endl;
+            return false;
+        }
+    }
+    if (options.paths.empty() || (!options.column_paths.empty() && options.output_path.empty() == !options.aggregate)) {
+        return false;
+    }
+    for (; i < argc; i++) {
+        int64_t value;
+        if (!ParseInteger(argv[i], value)) {
+            cerr << "Invalid argument: " << argv[i] << endl;
+            return false;
+        }
+        options.arguments.push_back(value);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+/// Print the aggregates.
+void PrintAggregates(const Aggregates& aggregates, const Aggregation& aggregation, ostream& out) {
+    out << "count: " << aggregates.count << ", sum: " << aggregates.sum;
+    if (aggregates.count) {
+        out << ", min: " << aggregates.min << ", max: " << aggregates.max;
+    }
+    out << endl;
+    for (size_t b = 0; b < aggregates.histogram.size(); b++) {
+        // The bounds wrap around like the bucket computation.
+        const auto lower = static_cast<int64_t>(static_cast<uint64_t>(aggregation.histogram_lower) + b * aggregation.histogram_width);
+        out << (b == 0 ? "(-inf" : "[" + to_string(lower)) << ", ";
+        out << (b + 1 == aggregates.histogram.size() ? "+inf)" : to_string(static_cast<int64_t>(static_cast<uint64_t>(lower) + aggregation.histogram_width)) + ")");
+        out << ": " << aggregates.histogram[b] << endl;
+    }
+}
+//---------------------------------------------------------------------------
+/// Read the source code.
+/// @return True for success, false for failure.
+bool ReadSource(const string& path, string& code) {
+    stringstream buffer;
+    if (path == "-") {
+        buffer << cin.rdbuf();
+    } else {
+        ifstream file(path);
+        if (!file) {
+            cerr << "Opening the source file failed: " << path << endl;
+            return false;
+        }
+        buffer << file.rdbuf();
+    }
+    code = buffer.str();
+    return true;
+}
+//---------------------------------------------------------------------------
+/// Run the frontend and the optimization outside of the JIT, which does not expose its intermediate results, and print them.
+/// @return True for success, false for failure (compilation error).
+bool Dump(const string& code, const Options& options) {
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    if (!parse_tree) { return false; }
+    if (options.dump_parse_tree) {
+        ParseTreeNodeVisitorDot visitor;
+        parse_tree->Accept(visitor);
+    }
+    SemanticAnalyzer semantic_analyzer;
+    unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(move(parse_tree));
+    if (!ast) { return false; }
+    if (options.dump_ast) {
+        ASTNodeVisitorDot visitor;
+        ast->Accept(visitor);
+    }
+    if (options.dump_optimized_ast || options.dump_ir) {
+        PassManager pass_manager;
+        pass_manager.Run(PassManager::GetPipelineName(options.level), *ast, semantic_analyzer.GetSymbolTable());
+    }
+    if (options.dump_optimized_ast) {
+        ASTNodeVisitorDot visitor;
+        ast->Accept(visitor);
+    }
+    if (options.dump_ir) {
+        IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+        builder.Build(*ast).Print(cout);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+/// Call the function repeatedly and print the latency percentiles.
+/// @return True for success, false for failure (an erroneous call).
+bool Bench(FunctionHandle& function, const Options& options) {
+    vector<uint64_t> latencies;
+    latencies.reserve(options.bench_calls);
+    for (uint64_t i = 0; i < options.bench_calls; i++) {
+        const auto begin = chrono::steady_clock::now();
+        const optional<int64_t> result = function.Call(options.arguments.data(), options.arguments.size());
+        latencies.push_back(static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - begin).count()));
+        if (!result) { return false; }
+    }
+    // The first call includes the compilation.
+    cout << "first call: " << latencies.front() << " ns" << endl;
+    sort(latencies.begin(), latencies.end());
+    uint64_t total = 0;
+    for (uint64_t latency : latencies) { total += latency; }
+    const auto percentile = [&latencies](double p) { return latencies[min(latencies.size() - 1, static_cast<size_t>(p * static_cast<double>(latencies.size())))]; };
+    cout << "calls: " << latencies.size() << ", mean: " << total / latencies.size() << " ns, min: " << latencies.front() << " ns, p50: " << percentile(0.5)
+         << " ns, p99: " << percentile(0.99) << " ns, p999: " << percentile(0.999) << " ns, max: " << latencies.back() << " ns" << endl;
+    return true;
+}
+//---------------------------------------------------------------------------
+/// Evaluate the functions for the rows of the standard input.
+/// @return True for success, false for failure.
+bool Serve(JIT& jit, const Options& options, vector<FunctionHandle>& functions) {
+    for (auto& path : options.paths) {
+        if (path == "-") {
+            cerr << "The standard input carries the rows, not the source code" << endl;
+            return false;
+        }
+        string code;
+        if (!ReadSource(path, code)) {
+            return false;
+        }
+        functions.push_back(jit.RegisterFunction(code, options.level));
+        functions.back().SetName(path);
+    }
+    // The rows are written in large chunks, so the synchronization with C's stdio is not needed.
+    ios::sync_with_stdio(false);
+    BatchServer server(functions, options.server_options);
+    return server.Serve(cin, cout);
+}
+//---------------------------------------------------------------------------
+/// Print the statistics of the function.
+void PrintStatistics(FunctionHandle& function, ostream& out) {
+    const FunctionStatistics::Snapshot statistics = function.GetStatistics();
+    const char* phases[] = {"parse", "semantic analysis", "optimization"};
+    static_assert(size(phases) == FunctionStatistics::number_of_phases);
+    out << "compilation:" << endl;
+    for (size_t i = 0; i < FunctionStatistics::number_of_phases; i++) {
+        out << "  " << phases[i] << ": " << statistics.compile_ns[i] << " ns";
+        if (AllocationTracker::IsEnabled()) {
+            out << ", " << statistics.compile_allocations[i] << " allocations, " << statistics.compile_peak_bytes[i] << " bytes peak";
+        }
+        out << endl;
+    }
+    const char* tiers[] = {"uncompiled", "interpreted", "constant"};
+    out << "calls: " << statistics.calls << ", division by zero errors: " << statistics.division_by_zero_errors
+         << ", total evaluation: " << statistics.total_evaluation_ns << " ns, max evaluation: " << statistics.max_evaluation_ns << " ns"
+         << ", tier: " << tiers[static_cast<size_t>(statistics.tier)] << endl;
+    const JIT::MemoryUsage memory = function.GetMemoryUsage();
+    out << "memory: " << memory.GetTotal() << " bytes (source: " << memory.source << ", ast: " << memory.ast << ", symbol table: " << memory.symbol_table
+         << ", frame template: " << memory.frame_template << ", result cache: " << memory.result_cache << ", code: " << memory.code
+         << ", statistics: " << memory.statistics << ")" << endl;
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        PrintUsage(argv[0]);
+        return 2;
+    }
+    JIT jit;
+    TraceRecorder trace_recorder;
+    if (!options.trace_path.empty()) {
+        jit.SetTraceRecorder(&trace_recorder);
+    }
+    if (options.serve) {
+        vector<FunctionHandle> functions;
+        const int status = Serve(jit, options, functions) ? 0 : 1;
+        if (options.stats) {
+            // The standard output carries the results.
+            for (auto& function : functions) {
+                cerr << function.GetName() << ":" << endl;
+                PrintStatistics(function, cerr);
+            }
+        }
+        if (!options.trace_path.empty() && !trace_recorder.WriteFile(options.trace_path)) {
+            cerr << "Writing the trace failed: " << options.trace_path << endl;
+            return 2;
+        }
+        return status;
+    }
+
+    string code;
+    if (!ReadSource(options.paths.front(), code)) {
+        return 2;
+    }
+    if (options.dump_parse_tree || options.dump_ast || options.dump_optimized_ast || options.dump_ir) {
+        if (!Dump(code, options)) {
+            return 1;
+        }
+        if (!options.bench_calls && !options.stats && options.trace_path.empty()) {
+            return 0;
+        }
+    }
+
+    FunctionHandle function = jit.RegisterFunction(code, options.level);
+    int status = 0;
+    if (options.bench_calls) {
+        status = Bench(function, options) ? 0 : 1;
+    } else if (!options.column_paths.empty()) {
+        ColumnEvaluator evaluator(function, options.column_options);
+        if (options.aggregate) {
+            Aggregates aggregates;
+            status = evaluator.AggregateFiles(options.column_paths, options.aggregation, aggregates) ? 0 : 1;
+            if (status == 0) {
+                PrintAggregates(aggregates, options.aggregation, cout);
+            }
+        } else {
+            status = evaluator.EvaluateFiles(options.column_paths, options.output_path, options.errors_path) ? 0 : 1;
+        }
+        const ColumnEvaluator::Statistics& statistics = evaluator.GetStatistics();
+        cout << "rows: " << statistics.rows << ", division by zero errors: " << statistics.division_by_zero_errors
+             << ", threads: " << statistics.threads << endl;
+    } else {
+        const optional<int64_t> result = function.Call(options.arguments.data(), options.arguments.size());
+        if (result) {
+            cout << *result << endl;
+        } else {
+            status = 1;
+        }
+    }
+    if (options.stats) {
+        PrintStatistics(function, cout);
+    }
+    if (!options.trace_path.empty() && !trace_recorder.WriteFile(options.trace_path)) {
+        cerr << "Writing the trace failed: " << options.trace_path << endl;
+        return 2;
+    }
+    return status;
 }
 //---------------------------------------------------------------------------
@@ -28,10 +28,13 @@ void ConstantPropagation::Optimize(FunctionAST& node) {
                     auto it_e = expressions.find(child.get());
                     if (it_e != expressions.end()) {
                         assert(expressions.find(statement->GetExpression().get()) != expressions.end());  // the child must be constant.
-                        assert(symbol_table.find(statement->GetIdentifier()->GetName())->second.IfInitialized());
-                        assert(symbol_table.find(statement->GetIdentifier()->GetName())->second.GetValue() == it_e->second);
                         assert(symbol_table.find(statement->GetIdentifier()->GetName())->second.GetType() != Symbol::Type::CONSTANT);
-                        statement->SetToConstantLiteral(it_e->second);
+                        if (statement->GetExpression()->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                            statement->SetToConstantLiteral(it_e->second);
+                            changed = true;
+                        }
+                    } else {
+                        FoldConstantChildren(*statement->GetExpression());
                     }
                     break;
                 }
@@ -41,7 +44,12 @@ void ConstantPropagation::Optimize(FunctionAST& node) {
                 if (it_e != expressions.end()) {
                     assert(expressions.find(statement->GetExpression().get()) != expressions.end());  // the child must be constant.
                     assert(return_value);
-                    statement->SetToConstantLiteral(*return_value);
+                    if (statement->GetExpression()->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                        statement->SetToConstantLiteral(it_e->second);
+                        changed = true;
+                    }
+                } else {
+                    FoldConstantChildren(*statement->GetExpression());
                 }
                 break;
             }
@@ -51,6 +59,45 @@ void ConstantPropagation::Optimize(FunctionAST& node) {
     }
 }
 //---------------------------------------------------------------------------
+void ConstantPropagation::FoldConstantChildren(ASTNode& node) {
+    // The node itself is not constant, but its children may be.
+    switch (node.GetType()) {
+        case ASTNode::Type::UnaryExpression:
+            {
+                auto& unary = static_cast<UnaryExpressionAST&>(node);
+                auto it = expressions.find(unary.GetChild().get());
+                if (it == expressions.end()) {
+                    FoldConstantChildren(*unary.GetChild());
+                } else if (unary.GetChild()->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                    unary.SetChildToConstantLiteral(it->second);
+                    changed = true;
+                }
+                break;
+            }
+        case ASTNode::Type::BinaryExpression:
+            {
+                auto& binary = static_cast<BinaryExpressionAST&>(node);
+                auto it_left = expressions.find(binary.GetLeftChild().get());
+                if (it_left == expressions.end()) {
+                    FoldConstantChildren(*binary.GetLeftChild());
+                } else if (binary.GetLeftChild()->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                    binary.SetLeftChildToConstantLiteral(it_left->second);
+                    changed = true;
+                }
+                auto it_right = expressions.find(binary.GetRightChild().get());
+                if (it_right == expressions.end()) {
+                    FoldConstantChildren(*binary.GetRightChild());
+                } else if (binary.GetRightChild()->GetType() != ASTNode::Type::LiteralPrimaryExpression) {
+                    binary.SetRightChildToConstantLiteral(it_right->second);
+                    changed = true;
+                }
+                break;
+            }
+        default:
+            break;
+    }
+}
+//---------------------------------------------------------------------------
 void ConstantPropagation::Visit(IdentifierPrimaryExpressionAST& node) {
     auto it = symbol_table.find(node.GetName());
     if (it != symbol_table.end() && (it->second.GetType() == Symbol::Type::CONSTANT || (it->second.GetType() == Symbol::Type::VARIABLE && it->second.IfInitialized()))) {
@@ -118,14 +165,20 @@ void ConstantPropagation::Visit(AssignmentStatementAST& node) {
     // assignment-expression = identifier ":=" additive-expression.
     node.GetExpression()->Accept(*this);
     auto it = expressions.find(node.GetExpression().get());
+    auto it_st = symbol_table.find(node.GetIdentifier()->GetName());
+    assert(it_st != symbol_table.end());
+    assert(it_st->second.GetType() != Symbol::Type::CONSTANT);
     if (it != expressions.end()) {
         // If the child (additive-expression) generates a constant, then this identifier is also a constant.
         expressions.emplace(&node, it->second);
-        // Update the identifier in symbol table.
-        auto it_st = symbol_table.find(node.GetIdentifier()->GetName());
-        it_st->second.SetInitialized();
-        assert(it_st->second.GetType() != Symbol::Type::CONSTANT);
-        it_st->second.SetValue(it->second);
+        // Update the identifier in symbol table. Only variables are tracked, parameters are never constant.
+        if (it_st->second.GetType() == Symbol::Type::VARIABLE) {
+            it_st->second.SetInitialized();
+            it_st->second.SetValue(it->second);
+        }
+    } else if (it_st->second.GetType() == Symbol::Type::VARIABLE) {
+        // A non-constant assignment: the variable is no longer a constant from here on.
+        it_st->second.SetUninitialized();
     }
 }
 //---------------------------------------------------------------------------
@@ -139,8 +192,10 @@ void ConstantPropagation::Visit(ReturnStatementAST& node) {
     if (it != expressions.end()) {
         // If the child (additive-expression) generates a constant, then this "RETURN" is also a constant.
         expressions.emplace(&node, it->second);
-        assert(!return_value);
-        return_value = it->second;
+        // Only the first "RETURN" is ever evaluated.
+        if (!return_value) {
+            return_value = it->second;
+        }
         assert(return_value);
     }
 }
@@ -22,6 +22,7 @@ void OptimizeDeadCode::Visit(ReturnStatementAST&) {}
 void OptimizeDeadCode::Visit(FunctionAST& node) {
     while (!node.GetChildren().empty() && node.GetChildren().back()->GetType() != ASTNode::Type::ReturnStatement) {
         node.EliminateLastChild();
+        changed = true;
     }
     assert(!node.GetChildren().empty());
     assert(node.GetChildren().back()->GetType() == ASTNode::Type::ReturnStatement); // last statement is "RETRUN".
@@ -0,0 +1,58 @@
+//---------------------------------------------------------------------------
+#include "optimization/DeadStoreElimination.hpp"
+#include <cassert>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Optimize(FunctionAST& node) { Visit(node); }
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(IdentifierPrimaryExpressionAST& node) { reads.insert(node.GetName()); }
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(LiteralPrimaryExpressionAST&) {}
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(UnaryExpressionAST& node) { node.GetChild()->Accept(*this); }
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(BinaryExpressionAST& node) {
+    if (node.GetBinaryOperatorType() == BinaryExpressionAST::BinaryOperator::DIV) {
+        division = true;
+    }
+    node.GetLeftChild()->Accept(*this);
+    node.GetRightChild()->Accept(*this);
+}
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(AssignmentStatementAST& node) { node.GetExpression()->Accept(*this); }
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(ReturnStatementAST& node) { node.GetExpression()->Accept(*this); }
+//---------------------------------------------------------------------------
+void DeadStoreElimination::Visit(FunctionAST& node) {
+    // Only the statements up to the first "RETURN" are evaluated.
+    size_t return_index = 0;
+    while (node.GetChildren()[return_index]->GetType() != ASTNode::Type::ReturnStatement) {
+        return_index++;
+        assert(return_index < node.GetChildren().size());  // Must have "RETURN".
+    }
+
+    // Walk backwards and keep track of the identifiers, which are read later on (live).
+    std::unordered_set<std::string_view> live;
+    node.GetChildren()[return_index]->Accept(*this);
+    live.swap(reads);
+    for (size_t child_index = return_index; child_index-- > 0;) {
+        auto* const statement = static_cast<AssignmentStatementAST*>(node.GetChildren()[child_index].get());
+        assert(statement->GetType() == ASTNode::Type::AssignmentStatement);
+        reads.clear();
+        division = false;
+        statement->Accept(*this);
+        const std::string_view name = statement->GetIdentifier()->GetName();
+        if (live.find(name) == live.end() && !division) {
+            node.EliminateChild(child_index);
+            changed = true;
+            continue;
+        }
+        // The value is overwritten here, the reads of the expression are live before.
+        live.erase(name);
+        live.insert(reads.begin(), reads.end());
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
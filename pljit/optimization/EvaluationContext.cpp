@@ -1,5 +1,6 @@
 //---------------------------------------------------------------------------
 #include "optimization/EvaluationContext.hpp"
+#include "util/MemoryUsage.hpp"
 //---------------------------------------------------------------------------
 namespace pljit {
 //---------------------------------------------------------------------------
@@ -17,5 +18,7 @@ void EvaluationContext::SetReturnValue(int64_t value) { return_value = value; }
 //---------------------------------------------------------------------------
 EvaluationContext::ValueTable& EvaluationContext::GetValueTable() { return value_table; }
 //---------------------------------------------------------------------------
+size_t EvaluationContext::GetMemoryUsage() const { return sizeof(EvaluationContext) + memory_usage::OfHashTable(value_table); }
+//---------------------------------------------------------------------------
 } // namespace pljit
 //---------------------------------------------------------------------------
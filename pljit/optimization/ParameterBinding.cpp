@@ -0,0 +1,31 @@
+//---------------------------------------------------------------------------
+#include "optimization/ParameterBinding.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+ParameterBinding::ParameterBinding(SymbolTable& symbol_table, const Bindings& bindings) : symbol_table(symbol_table), bindings(bindings) {}
+//---------------------------------------------------------------------------
+bool ParameterBinding::Bind(FunctionAST& node, std::vector<std::string_view>& parameters) {
+    for (auto& [name, value] : bindings) {
+        auto it = symbol_table.find(name);
+        if (it == symbol_table.end() || it->second.GetType() != Symbol::Type::PARAMETER) {
+            std::cerr << "Binding an undeclared parameter: " << name << std::endl;
+            return false /* failure */;
+        }
+        // The symbol table's key refers to the source code, which outlives the AST.
+        const std::string_view parameter = it->first;
+        it->second.SetToVariable();
+        node.PrependChild(std::make_unique<AssignmentStatementAST>(std::make_unique<IdentifierPrimaryExpressionAST>(parameter),
+                                                                   std::make_unique<LiteralPrimaryExpressionAST>(value)));
+        auto it_p = std::find(parameters.begin(), parameters.end(), parameter);
+        assert(it_p != parameters.end());
+        parameters.erase(it_p);
+    }
+    return true;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,64 @@
+//---------------------------------------------------------------------------
+#include "optimization/PassManager.hpp"
+#include "optimization/ConstantPropagation.hpp"
+#include "optimization/DeadCodeElimination.hpp"
+#include "optimization/DeadStoreElimination.hpp"
+#include <cassert>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+PassManager::PassManager() {
+    AddPass("dead-code-elimination", [](const SymbolTable&) { return std::make_unique<OptimizeDeadCode>(); });
+    AddPass("constant-propagation", [](const SymbolTable& symbol_table) { return std::make_unique<ConstantPropagation>(symbol_table); });
+    AddPass("dead-store-elimination", [](const SymbolTable&) { return std::make_unique<DeadStoreElimination>(); });
+    AddPipeline(std::string(GetPipelineName(OptimizationLevel::O0)), {});
+    AddPipeline(std::string(GetPipelineName(OptimizationLevel::O1)), {"dead-code-elimination"});
+    AddPipeline(std::string(GetPipelineName(OptimizationLevel::O2)), {"dead-code-elimination", "constant-propagation"});
+    AddPipeline(std::string(GetPipelineName(OptimizationLevel::O3)), {"dead-code-elimination", "constant-propagation", "dead-store-elimination"}, default_max_iterations);
+}
+//---------------------------------------------------------------------------
+void PassManager::AddPass(std::string name, PassFactory factory) { passes.insert_or_assign(std::move(name), std::move(factory)); }
+//---------------------------------------------------------------------------
+bool PassManager::AddPipeline(std::string name, std::vector<std::string> pipeline_passes, size_t max_iterations) {
+    for (auto& pass : pipeline_passes) {
+        if (passes.find(pass) == passes.end()) {
+            return false /* failure */;
+        }
+    }
+    pipelines.insert_or_assign(std::move(name), Pipeline{std::move(pipeline_passes), max_iterations});
+    return true;
+}
+//---------------------------------------------------------------------------
+bool PassManager::HasPipeline(std::string_view name) const { return pipelines.find(std::string(name)) != pipelines.end(); }
+//---------------------------------------------------------------------------
+size_t PassManager::Run(std::string_view name, FunctionAST& node, const SymbolTable& symbol_table, TraceRecorder* trace_recorder, std::string_view function) const {
+    auto it = pipelines.find(std::string(name));
+    assert(it != pipelines.end());
+    const Pipeline& pipeline = it->second;
+    size_t iteration = 0;
+    bool changed = true;
+    while (changed && iteration < pipeline.max_iterations && !pipeline.passes.empty()) {
+        changed = false;
+        for (auto& pass_name : pipeline.passes) {
+            TraceSpan span(trace_recorder, pass_name, "optimization", function);
+            std::unique_ptr<OptimizationPass> pass = passes.at(pass_name)(symbol_table);
+            pass->Optimize(node);
+            changed |= pass->HasChanged();
+        }
+        iteration++;
+    }
+    return iteration;
+}
+//---------------------------------------------------------------------------
+std::string_view PassManager::GetPipelineName(OptimizationLevel level) {
+    switch (level) {
+        case OptimizationLevel::O0: return "O0";
+        case OptimizationLevel::O1: return "O1";
+        case OptimizationLevel::O2: return "O2";
+        case OptimizationLevel::O3: return "O3";
+    }
+    __builtin_unreachable();
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,104 @@
+//---------------------------------------------------------------------------
+#include "util/AllocationTracker.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// The counters of a thread.
+struct ThreadCounters {
+    /// The bytes allocated and not freed by the thread. Negative, if it freed memory of other threads.
+    int64_t bytes = 0;
+    /// The peak of `bytes` in the innermost scope.
+    int64_t peak_bytes = 0;
+    /// The number of allocations.
+    uint64_t allocations = 0;
+    /// The number of allocated bytes.
+    uint64_t allocated_bytes = 0;
+};
+//---------------------------------------------------------------------------
+/// The counters of the thread. Trivially constructed, so they can be used by allocations during the thread's startup.
+thread_local ThreadCounters counters;
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+AllocationTracker::Scope::Scope()
+ : begin_bytes(counters.bytes), begin_allocations(counters.allocations), begin_allocated_bytes(counters.allocated_bytes), outer_peak_bytes(counters.peak_bytes) {
+    counters.peak_bytes = counters.bytes;
+}
+//---------------------------------------------------------------------------
+AllocationTracker::Scope::~Scope() {
+    counters.peak_bytes = std::max(outer_peak_bytes, counters.peak_bytes);
+}
+//---------------------------------------------------------------------------
+AllocationTracker::Statistics AllocationTracker::Scope::GetStatistics() const {
+    Statistics statistics;
+    statistics.allocations = counters.allocations - begin_allocations;
+    statistics.allocated_bytes = counters.allocated_bytes - begin_allocated_bytes;
+    statistics.peak_bytes = static_cast<uint64_t>(std::max<int64_t>(counters.peak_bytes - begin_bytes, 0));
+    return statistics;
+}
+//---------------------------------------------------------------------------
+bool AllocationTracker::IsEnabled() {
+#ifdef PLJIT_TRACK_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
+#ifdef PLJIT_TRACK_ALLOCATIONS
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// Allocate and count.
+void* Allocate(size_t size) noexcept {
+    void* pointer = std::malloc(size ? size : 1);
+    if (pointer) {
+        // The usable size is also known when freeing.
+        const auto usable = static_cast<int64_t>(malloc_usable_size(pointer));
+        pljit::counters.bytes += usable;
+        pljit::counters.peak_bytes = std::max(pljit::counters.peak_bytes, pljit::counters.bytes);
+        pljit::counters.allocations++;
+        pljit::counters.allocated_bytes += static_cast<uint64_t>(usable);
+    }
+    return pointer;
+}
+//---------------------------------------------------------------------------
+/// Free and count.
+void Free(void* pointer) noexcept {
+    if (pointer) {
+        pljit::counters.bytes -= static_cast<int64_t>(malloc_usable_size(pointer));
+        std::free(pointer);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+void* operator new(size_t size) {
+    void* pointer = Allocate(size);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+void* operator new[](size_t size) {
+    void* pointer = Allocate(size);
+    if (!pointer) { throw std::bad_alloc(); }
+    return pointer;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void operator delete(void* pointer) noexcept { Free(pointer); }
+void operator delete[](void* pointer) noexcept { Free(pointer); }
+void operator delete(void* pointer, size_t) noexcept { Free(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { Free(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { Free(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { Free(pointer); }
+//---------------------------------------------------------------------------
+#endif
+//---------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+//---------------------------------------------------------------------------
+#include "util/Executor.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+Executor::Executor(size_t threads) {
+    const size_t number_of_threads = threads ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+    for (size_t t = 0; t < number_of_threads; t++) {
+        this->threads.emplace_back(&Executor::WorkerLoop, this);
+    }
+}
+//---------------------------------------------------------------------------
+Executor::~Executor() {
+    {
+        std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+//---------------------------------------------------------------------------
+size_t Executor::GetNumberOfThreads() const { return threads.size(); }
+//---------------------------------------------------------------------------
+void Executor::Submit(Job job) {
+    {
+        std::scoped_lock lock(mutex);
+        jobs.push_back(std::move(job));
+    }
+    condition.notify_one();
+}
+//---------------------------------------------------------------------------
+bool Executor::IsWorkerThread() const {
+    const auto id = std::this_thread::get_id();
+    return std::any_of(threads.begin(), threads.end(), [&](const std::thread& thread) { return thread.get_id() == id; });
+}
+//---------------------------------------------------------------------------
+void Executor::WorkerLoop() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&] { return !jobs.empty() || stopping; });
+            if (jobs.empty()) {
+                return;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+        }
+        job();
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
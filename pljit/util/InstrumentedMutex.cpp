@@ -0,0 +1,42 @@
+//---------------------------------------------------------------------------
+#include "util/InstrumentedMutex.hpp"
+#include <chrono>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+InstrumentedMutex::Statistics& InstrumentedMutex::Statistics::operator+=(const Statistics& other) {
+    acquisitions += other.acquisitions;
+    contentions += other.contentions;
+    wait_ns += other.wait_ns;
+    return *this;
+}
+//---------------------------------------------------------------------------
+void InstrumentedMutex::lock() {
+    if (!mutex.try_lock()) {
+        const auto begin = std::chrono::steady_clock::now();
+        mutex.lock();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+        contentions.fetch_add(1, std::memory_order_relaxed);
+        wait_ns.fetch_add(static_cast<uint64_t>(ns), std::memory_order_relaxed);
+    }
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+//---------------------------------------------------------------------------
+bool InstrumentedMutex::try_lock() {
+    if (!mutex.try_lock()) {
+        return false;
+    }
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+//---------------------------------------------------------------------------
+InstrumentedMutex::Statistics InstrumentedMutex::GetStatistics() const {
+    Statistics statistics;
+    statistics.acquisitions = acquisitions.load(std::memory_order_relaxed);
+    statistics.contentions = contentions.load(std::memory_order_relaxed);
+    statistics.wait_ns = wait_ns.load(std::memory_order_relaxed);
+    return statistics;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,95 @@
+//---------------------------------------------------------------------------
+#include "util/MappedFile.hpp"
+#include <iostream>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+MappedFile::~MappedFile() { Close(); }
+//---------------------------------------------------------------------------
+MappedFile::MappedFile(MappedFile&& other) noexcept : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)) {}
+//---------------------------------------------------------------------------
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        Close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+    }
+    return *this;
+}
+//---------------------------------------------------------------------------
+bool MappedFile::OpenRead(const std::string& path) {
+    Close();
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Opening the file failed: " << path << std::endl;
+        return false;
+    }
+    struct stat status {};
+    if (fstat(fd, &status) != 0) {
+        std::cerr << "Reading the size of the file failed: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+    const auto file_size = static_cast<size_t>(status.st_size);
+    // An empty file cannot be mapped, and has no bytes to read.
+    if (file_size > 0) {
+        void* memory = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED) {
+            std::cerr << "Mapping the file failed: " << path << std::endl;
+            close(fd);
+            return false;
+        }
+        madvise(memory, file_size, MADV_SEQUENTIAL);
+        data = static_cast<uint8_t*>(memory);
+        size = file_size;
+    }
+    // The mapping keeps the file alive.
+    close(fd);
+    return true;
+}
+//---------------------------------------------------------------------------
+bool MappedFile::Create(const std::string& path, size_t file_size) {
+    Close();
+    const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Creating the file failed: " << path << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        std::cerr << "Resizing the file failed: " << path << std::endl;
+        close(fd);
+        return false;
+    }
+    if (file_size > 0) {
+        void* memory = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED) {
+            std::cerr << "Mapping the file failed: " << path << std::endl;
+            close(fd);
+            return false;
+        }
+        data = static_cast<uint8_t*>(memory);
+        size = file_size;
+    }
+    close(fd);
+    return true;
+}
+//---------------------------------------------------------------------------
+void MappedFile::Close() {
+    if (data) {
+        munmap(data, size);
+    }
+    data = nullptr;
+    size = 0;
+}
+//---------------------------------------------------------------------------
+uint8_t* MappedFile::GetData() const { return data; }
+//---------------------------------------------------------------------------
+size_t MappedFile::GetSize() const { return size; }
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
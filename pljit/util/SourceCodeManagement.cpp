@@ -1,5 +1,6 @@
 //---------------------------------------------------------------------------
 #include "util/SourceCodeManagement.hpp"
+#include "util/MemoryUsage.hpp"
 #include <cassert>
 #include <sstream>
 #include <string>
@@ -31,5 +32,13 @@ size_t SourceCodeManagement::GetLineLength(size_t line_number) const {
     return loc[line_number].size();
 }
 //---------------------------------------------------------------------------
+size_t SourceCodeManagement::GetMemoryUsage() const {
+    size_t bytes = sizeof(SourceCodeManagement) + memory_usage::Of(loc);
+    for (auto& line : loc) {
+        bytes += memory_usage::Of(line);
+    }
+    return bytes;
+}
+//---------------------------------------------------------------------------
 } // namespace pljit
 //---------------------------------------------------------------------------
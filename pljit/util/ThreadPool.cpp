@@ -0,0 +1,140 @@
+//---------------------------------------------------------------------------
+#include "util/ThreadPool.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+ThreadPool::ThreadPool(size_t threads) : number_of_threads(threads ? threads : std::max(std::thread::hardware_concurrency(), 1u)) {
+    ranges = std::make_unique<Range[]>(number_of_threads);
+    for (size_t t = 1; t < number_of_threads; t++) {
+        workers.emplace_back(&ThreadPool::WorkerLoop, this, t);
+    }
+}
+//---------------------------------------------------------------------------
+ThreadPool::~ThreadPool() {
+    {
+        std::scoped_lock lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+//---------------------------------------------------------------------------
+size_t ThreadPool::GetNumberOfThreads() const { return number_of_threads; }
+//---------------------------------------------------------------------------
+ThreadPool::Statistics ThreadPool::GetStatistics() const {
+    Statistics statistics;
+    statistics.loops = loops.load(std::memory_order_relaxed);
+    statistics.tasks = tasks.load(std::memory_order_relaxed);
+    statistics.steals = steals.load(std::memory_order_relaxed);
+    return statistics;
+}
+//---------------------------------------------------------------------------
+void ThreadPool::ParallelFor(size_t number_of_tasks, const Task& task) {
+    if (number_of_tasks == 0) {
+        return;
+    }
+    loops.fetch_add(1, std::memory_order_relaxed);
+    tasks.fetch_add(number_of_tasks, std::memory_order_relaxed);
+    std::unique_lock loop_lock(loop_mutex, std::try_to_lock);
+    if (number_of_threads == 1 || number_of_tasks == 1 || !loop_lock.owns_lock()) {
+        for (size_t t = 0; t < number_of_tasks; t++) {
+            task(t, 0);
+        }
+        return;
+    }
+
+    // Every thread starts with a contiguous range of the tasks.
+    for (size_t t = 0; t < number_of_threads; t++) {
+        std::scoped_lock lock(ranges[t].mutex);
+        ranges[t].begin = number_of_tasks * t / number_of_threads;
+        ranges[t].end = number_of_tasks * (t + 1) / number_of_threads;
+    }
+    remaining_tasks = number_of_tasks;
+    {
+        std::scoped_lock lock(mutex);
+        current_task = &task;
+        running = true;
+        generation++;
+    }
+    condition.notify_all();
+    Work(0, task);
+    // Tasks may still run on the workers, or be in transit between two ranges by a steal.
+    while (remaining_tasks.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+    {
+        std::scoped_lock lock(mutex);
+        running = false;
+        current_task = nullptr;
+    }
+    // A worker, which joined the loop, may still search for tasks to steal.
+    while (active_workers.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+//---------------------------------------------------------------------------
+void ThreadPool::WorkerLoop(size_t thread) {
+    uint64_t seen_generation = 0;
+    while (true) {
+        const Task* task;
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&] { return stopping || (running && generation != seen_generation); });
+            if (stopping) {
+                return;
+            }
+            seen_generation = generation;
+            task = current_task;
+            active_workers.fetch_add(1, std::memory_order_acq_rel);
+        }
+        Work(thread, *task);
+        active_workers.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+//---------------------------------------------------------------------------
+void ThreadPool::Work(size_t thread, const Task& task) {
+    Range& own = ranges[thread];
+    while (remaining_tasks.load(std::memory_order_acquire) != 0) {
+        // Take a task from the front of the own range.
+        size_t index = 0;
+        bool found = false;
+        {
+            std::scoped_lock lock(own.mutex);
+            if (own.begin < own.end) {
+                index = own.begin++;
+                found = true;
+            }
+        }
+        if (found) {
+            task(index, thread);
+            remaining_tasks.fetch_sub(1, std::memory_order_acq_rel);
+            continue;
+        }
+        // Steal the back half of the range of another thread: the first task is run, the rest goes into the own range.
+        for (size_t offset = 1; offset < number_of_threads && !found; offset++) {
+            Range& victim = ranges[(thread + offset) % number_of_threads];
+            std::scoped_lock lock(victim.mutex, own.mutex);
+            if (victim.begin < victim.end) {
+                const size_t middle = victim.begin + (victim.end - victim.begin) / 2;
+                own.begin = middle + 1;
+                own.end = victim.end;
+                victim.end = middle;
+                index = middle;
+                found = true;
+            }
+        }
+        if (!found) {
+            // The remaining tasks run on other threads.
+            return;
+        }
+        steals.fetch_add(1, std::memory_order_relaxed);
+        task(index, thread);
+        remaining_tasks.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,115 @@
+//---------------------------------------------------------------------------
+#include "util/Trace.hpp"
+#include <fstream>
+#include <iostream>
+#include <sys/syscall.h>
+#include <unistd.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Get the id of the calling thread, as shown by the kernel.
+static uint32_t GetThreadId() {
+    thread_local const auto thread_id = static_cast<uint32_t>(syscall(SYS_gettid));
+    return thread_id;
+}
+//---------------------------------------------------------------------------
+/// Write a JSON string, escaping the special characters.
+static void WriteString(std::ostream& out, std::string_view string) {
+    out << '"';
+    for (char c : string) {
+        switch (c) {
+            case '"': out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            case '\t': out << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    const char* hex = "0123456789abcdef";
+                    out << "\\u00" << hex[c >> 4] << hex[c & 0xF];
+                } else {
+                    out << c;
+                }
+        }
+    }
+    out << '"';
+}
+//---------------------------------------------------------------------------
+/// Write nanoseconds as the microseconds of the trace event format.
+static void WriteMicroseconds(std::ostream& out, uint64_t ns) {
+    out << ns / 1000 << '.' << (ns % 1000) / 100 << (ns % 100) / 10 << ns % 10;
+}
+//---------------------------------------------------------------------------
+TraceRecorder::TraceRecorder(size_t max_events) : max_events(max_events), start(std::chrono::steady_clock::now()) {}
+//---------------------------------------------------------------------------
+void TraceRecorder::Record(std::string_view name, std::string_view category, std::string_view function, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+    const auto begin_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(begin - start).count());
+    const auto duration_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+    const uint32_t thread_id = GetThreadId();
+    std::scoped_lock lock(mutex);
+    if (events.size() >= max_events) {
+        dropped_events++;
+        return;
+    }
+    events.push_back(Event{std::string(name), std::string(category), std::string(function), begin_ns, duration_ns, thread_id});
+}
+//---------------------------------------------------------------------------
+std::vector<TraceRecorder::Event> TraceRecorder::GetEvents() const {
+    std::scoped_lock lock(mutex);
+    return events;
+}
+//---------------------------------------------------------------------------
+size_t TraceRecorder::GetDroppedEvents() const {
+    std::scoped_lock lock(mutex);
+    return dropped_events;
+}
+//---------------------------------------------------------------------------
+void TraceRecorder::Write(std::ostream& out) const {
+    std::scoped_lock lock(mutex);
+    const pid_t pid = getpid();
+    out << "{\"traceEvents\":[";
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& event = events[i];
+        out << (i ? ",\n" : "\n") << "{\"name\":";
+        WriteString(out, event.name);
+        out << ",\"cat\":";
+        WriteString(out, event.category);
+        out << ",\"ph\":\"X\",\"ts\":";
+        WriteMicroseconds(out, event.begin_ns);
+        out << ",\"dur\":";
+        WriteMicroseconds(out, event.duration_ns);
+        out << ",\"pid\":" << pid << ",\"tid\":" << event.thread_id;
+        if (!event.function.empty()) {
+            out << ",\"args\":{\"function\":";
+            WriteString(out, event.function);
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+//---------------------------------------------------------------------------
+bool TraceRecorder::WriteFile(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Opening the trace file failed: " << path << std::endl;
+        return false;
+    }
+    Write(file);
+    return static_cast<bool>(file);
+}
+//---------------------------------------------------------------------------
+TraceSpan::TraceSpan(TraceRecorder* recorder, std::string_view name, std::string_view category, std::string_view function)
+ : recorder(recorder), name(name), category(category), function(function) {
+    if (recorder) {
+        begin = std::chrono::steady_clock::now();
+    }
+}
+//---------------------------------------------------------------------------
+TraceSpan::~TraceSpan() {
+    if (recorder) {
+        recorder->Record(name, category, function, begin, std::chrono::steady_clock::now());
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,131 @@
+//---------------------------------------------------------------------------
+#include "util/WorkloadGenerator.hpp"
+#include <algorithm>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+WorkloadGenerator::WorkloadGenerator(uint64_t seed) : WorkloadGenerator(seed, Options()) {}
+//---------------------------------------------------------------------------
+WorkloadGenerator::WorkloadGenerator(uint64_t seed, Options options) : options(options), state(seed) {}
+//---------------------------------------------------------------------------
+uint64_t WorkloadGenerator::Next() {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+//---------------------------------------------------------------------------
+uint64_t WorkloadGenerator::Uniform(uint64_t n) { return Next() % n; }
+//---------------------------------------------------------------------------
+bool WorkloadGenerator::Percent(uint32_t percent) { return Uniform(100) < percent; }
+//---------------------------------------------------------------------------
+void WorkloadGenerator::AppendName(char prefix, size_t index) {
+    code += prefix;
+    const size_t begin = code.size();
+    do {
+        code += static_cast<char>('a' + index % 26);
+        index /= 26;
+    } while (index);
+    std::reverse(code.begin() + begin, code.end());
+}
+//---------------------------------------------------------------------------
+void WorkloadGenerator::AppendLiteral(int64_t min) {
+    const int64_t max = std::max(options.max_literal, min);
+    code += std::to_string(min + static_cast<int64_t>(Uniform(static_cast<uint64_t>(max - min) + 1)));
+}
+//---------------------------------------------------------------------------
+void WorkloadGenerator::AppendOperand() {
+    if (Percent(options.negation_percent)) {
+        code += '-';
+    }
+    const size_t readable = options.number_of_parameters + initialized_variables;
+    if (readable == 0 || Percent(options.constant_density_percent)) {
+        if (options.number_of_constants > 0 && Percent(50)) {
+            AppendName('c', Uniform(options.number_of_constants));
+        } else {
+            AppendLiteral(0);
+        }
+        return;
+    }
+    const size_t index = Uniform(readable);
+    if (index < options.number_of_parameters) {
+        AppendName('p', index);
+    } else {
+        AppendName('v', index - options.number_of_parameters);
+    }
+}
+//---------------------------------------------------------------------------
+void WorkloadGenerator::AppendExpression(size_t depth) {
+    if (depth == 0 || Percent(25)) {
+        AppendOperand();
+        return;
+    }
+    // The operands are parenthesized, so the generated tree is the parsed one regardless of the precedence.
+    const bool division = Percent(options.division_percent);
+    code += '(';
+    AppendExpression(depth - 1);
+    code += ')';
+    if (division) {
+        code += " / ";
+        if (options.nonzero_divisors) {
+            AppendLiteral(1);
+            return;
+        }
+    } else {
+        const uint64_t total = uint64_t(options.add_weight) + options.sub_weight + options.mul_weight;
+        const uint64_t choice = total ? Uniform(total) : 0;
+        code += choice < options.add_weight ? " + " : choice < options.add_weight + options.sub_weight ? " - " : " * ";
+    }
+    code += '(';
+    AppendExpression(depth - 1);
+    code += ')';
+}
+//---------------------------------------------------------------------------
+void WorkloadGenerator::AppendDeclarations(const char* keyword, char prefix, size_t count, bool constants) {
+    if (count == 0) {
+        return;
+    }
+    code += keyword;
+    for (size_t i = 0; i < count; i++) {
+        code += i ? ", " : " ";
+        AppendName(prefix, i);
+        if (constants) {
+            code += " = ";
+            AppendLiteral(0);
+        }
+    }
+    code += ";\n";
+}
+//---------------------------------------------------------------------------
+std::string WorkloadGenerator::Generate() {
+    code.clear();
+    initialized_variables = 0;
+    AppendDeclarations("PARAM", 'p', options.number_of_parameters, false);
+    AppendDeclarations("VAR", 'v', options.number_of_variables, false);
+    AppendDeclarations("CONST", 'c', options.number_of_constants, true);
+    code += "BEGIN\n";
+    const size_t assignable = options.number_of_parameters + options.number_of_variables;
+    for (size_t i = 0; assignable > 0 && i < options.number_of_statements; i++) {
+        // Variables are initialized in declaration order, so an expression only reads initialized ones.
+        const size_t index = Uniform(std::min(assignable, options.number_of_parameters + initialized_variables + 1));
+        code += "    ";
+        if (index < options.number_of_parameters) {
+            AppendName('p', index);
+        } else {
+            AppendName('v', index - options.number_of_parameters);
+        }
+        code += " := ";
+        AppendExpression(options.max_expression_depth);
+        code += ";\n";
+        if (index == options.number_of_parameters + initialized_variables) {
+            initialized_variables++;
+        }
+    }
+    code += "    RETURN ";
+    AppendExpression(options.max_expression_depth);
+    code += "\nEND.\n";
+    return code;
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+#include "jit/ArrowEvaluator.hpp"
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+namespace {
+//---------------------------------------------------------------------------
+/// An int64 column in the Arrow layout, owned by the test.
+struct Column {
+    std::vector<int64_t> values;
+    std::vector<uint8_t> validity;
+    const void* buffers[2] = {nullptr, nullptr};
+    ArrowSchema schema{};
+    ArrowArray array{};
+
+    /// Constructor, the rows with a `null` entry are null.
+    Column(std::vector<int64_t> column_values, const std::vector<bool>& null, int64_t offset = 0) : values(std::move(column_values)) {
+        int64_t null_count = 0;
+        validity.assign((values.size() + 7) / 8, 0);
+        for (size_t r = 0; r < values.size(); r++) {
+            const bool is_null = r < null.size() && null[r];
+            validity[r / 8] |= static_cast<uint8_t>(!is_null << (r % 8));
+            null_count += is_null && static_cast<int64_t>(r) >= offset;
+        }
+        buffers[0] = validity.data();
+        buffers[1] = values.data();
+        schema.format = "l";
+        schema.release = [](ArrowSchema* s) { s->release = nullptr; };
+        array.length = static_cast<int64_t>(values.size()) - offset;
+        array.null_count = null_count;
+        array.offset = offset;
+        array.n_buffers = 2;
+        array.buffers = buffers;
+        array.release = [](ArrowArray* a) { a->release = nullptr; };
+    }
+};
+//---------------------------------------------------------------------------
+/// Check if a row of the result is valid.
+bool IsValid(const ArrowArray& array, int64_t row) {
+    const auto* validity = static_cast<const uint8_t*>(array.buffers[0]);
+    return !validity || ((validity[(array.offset + row) / 8] >> ((array.offset + row) % 8)) & 1);
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(ArrowEvaluator, Columns) {
+    JIT jit;
+    ArrowEvaluator evaluator(jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END."));
+    // The first column starts at an offset, which is not a multiple of 8.
+    Column a({99, 99, 99, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100}, {false, true, false, false, true}, 3);
+    Column b({1, 2, 0, 4, 5, 6, 7, 8, 9, 10}, {false, false, false, false, false, false, true});
+    ArrowSchema result_schema;
+    ArrowArray result;
+    ASSERT_TRUE(evaluator.Evaluate({&a.schema, &b.schema}, {&a.array, &b.array}, &result_schema, &result));
+    ASSERT_EQ(result.length, 10);
+    EXPECT_EQ(result.offset, 0);
+    EXPECT_EQ(result.n_buffers, 2);
+    // Row 1 is null in a, row 2 divides by zero, row 6 is null in b.
+    EXPECT_EQ(result.null_count, 3);
+    const auto* values = static_cast<const int64_t*>(result.buffers[1]);
+    for (int64_t r = 0; r < 10; r++) {
+        const bool valid = r != 1 && r != 2 && r != 6;
+        EXPECT_EQ(IsValid(result, r), valid) << r;
+        EXPECT_EQ(values[r], valid ? a.values[r + 3] / b.values[r] : 0) << r;
+    }
+    EXPECT_STREQ(result_schema.format, "l");
+    EXPECT_EQ(result_schema.flags & ARROW_FLAG_NULLABLE, ARROW_FLAG_NULLABLE);
+    EXPECT_EQ(evaluator.GetStatistics().division_by_zero_errors, 1u);
+    result.release(&result);
+    result_schema.release(&result_schema);
+    EXPECT_EQ(result.release, nullptr);
+    EXPECT_EQ(result_schema.release, nullptr);
+}
+//---------------------------------------------------------------------------
+TEST(ArrowEvaluator, RecordBatch) {
+    JIT jit;
+    ArrowEvaluator evaluator(jit.RegisterFunction("PARAM a, b; BEGIN RETURN a * b END."));
+    std::vector<int64_t> a_values;
+    std::vector<int64_t> b_values;
+    for (int64_t r = 0; r < 100; r++) {
+        a_values.push_back(r);
+        b_values.push_back(r - 50);
+    }
+    Column a(a_values, {});
+    Column b(b_values, {});
+    a.array.null_count = 0;
+    b.array.null_count = 0;
+    // A struct with an offset of 8 rows, whose row 8 (the first one) is null.
+    std::vector<uint8_t> struct_validity(13, 0xFF);
+    struct_validity[1] = 0xFE;
+    const void* struct_buffers[1] = {struct_validity.data()};
+    ArrowSchema* child_schemas[2] = {&a.schema, &b.schema};
+    ArrowArray* child_arrays[2] = {&a.array, &b.array};
+    ArrowSchema schema{};
+    schema.format = "+s";
+    schema.n_children = 2;
+    schema.children = child_schemas;
+    ArrowArray batch{};
+    batch.length = 92;
+    batch.null_count = 1;
+    batch.offset = 8;
+    batch.n_buffers = 1;
+    batch.n_children = 2;
+    batch.buffers = struct_buffers;
+    batch.children = child_arrays;
+    ArrowSchema result_schema;
+    ArrowArray result;
+    ASSERT_TRUE(evaluator.EvaluateRecordBatch(schema, batch, &result_schema, &result));
+    ASSERT_EQ(result.length, 92);
+    EXPECT_EQ(result.null_count, 1);
+    const auto* values = static_cast<const int64_t*>(result.buffers[1]);
+    EXPECT_FALSE(IsValid(result, 0));
+    for (int64_t r = 1; r < 92; r++) {
+        EXPECT_TRUE(IsValid(result, r));
+        EXPECT_EQ(values[r], (r + 8) * (r + 8 - 50));
+    }
+    result.release(&result);
+    result_schema.release(&result_schema);
+}
+//---------------------------------------------------------------------------
+TEST(ArrowEvaluator, Errors) {
+    JIT jit;
+    ArrowEvaluator evaluator(jit.RegisterFunction("PARAM a, b; BEGIN RETURN a + b END."));
+    Column a({1, 2, 3}, {});
+    Column b({1, 2}, {});
+    ArrowSchema result_schema;
+    ArrowArray result;
+    // Too few rows.
+    EXPECT_FALSE(evaluator.Evaluate({&a.schema, &b.schema}, {&a.array, &b.array}, &result_schema, &result));
+    // Not int64.
+    Column c({1, 2, 3}, {});
+    c.schema.format = "i";
+    EXPECT_FALSE(evaluator.Evaluate({&a.schema, &c.schema}, {&a.array, &c.array}, &result_schema, &result));
+    // A wrong number of columns.
+    EXPECT_FALSE(evaluator.Evaluate({&a.schema}, {&a.array}, &result_schema, &result));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,117 @@
+#include "jit/BatchServer.hpp"
+#include <cstring>
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(BatchServer, Text) {
+    JIT jit;
+    std::vector<FunctionHandle> functions = {jit.RegisterFunction("PARAM a, b; BEGIN RETURN a + b END."),
+                                             jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.")};
+    BatchServer::Options options;
+    // Small batches and chunks, so rows span several of both.
+    options.batch_size = 2;
+    options.chunk_size = 5;
+    BatchServer server(functions, options);
+    std::istringstream in("1 2\n"
+                          "\n"
+                          "-7,\t2\r\n"
+                          "4 0\n"
+                          "+9223372036854775807 -1");
+    std::ostringstream out;
+    ASSERT_TRUE(server.Serve(in, out));
+    EXPECT_EQ(out.str(), "3 0\n"
+                         "-5 -3\n"
+                         "4 error\n"
+                         "9223372036854775806 -9223372036854775807\n");
+    EXPECT_EQ(server.GetStatistics().rows, 4u);
+    EXPECT_EQ(server.GetStatistics().batches, 2u);
+    EXPECT_EQ(server.GetStatistics().division_by_zero_errors, 1u);
+    EXPECT_EQ(functions[1].GetStatistics().calls, 4u);
+}
+//---------------------------------------------------------------------------
+TEST(BatchServer, Binary) {
+    JIT jit;
+    std::vector<FunctionHandle> functions = {jit.RegisterFunction("PARAM a, b; BEGIN RETURN a * b END."),
+                                             jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.")};
+    BatchServer::Options options;
+    options.format = BatchServer::Format::Binary;
+    options.batch_size = 3;
+    BatchServer server(functions, options);
+    std::vector<int64_t> input;
+    for (int64_t i = 0; i < 10; i++) {
+        input.push_back(i);
+        input.push_back(i % 4);
+    }
+    std::istringstream in(std::string(reinterpret_cast<const char*>(input.data()), input.size() * sizeof(int64_t)));
+    std::ostringstream out;
+    ASSERT_TRUE(server.Serve(in, out));
+    const std::string output = out.str();
+    ASSERT_EQ(output.size(), 10 * 3 * sizeof(int64_t));
+    std::vector<int64_t> records(30);
+    std::memcpy(records.data(), output.data(), output.size());
+    for (int64_t i = 0; i < 10; i++) {
+        EXPECT_EQ(records[i * 3], i * (i % 4));
+        EXPECT_EQ(records[i * 3 + 1], i % 4 ? i / (i % 4) : 0);
+        EXPECT_EQ(records[i * 3 + 2], i % 4 ? 0 : 2);
+    }
+    EXPECT_EQ(server.GetStatistics().batches, 4u);
+}
+//---------------------------------------------------------------------------
+TEST(BatchServer, Errors) {
+    JIT jit;
+    auto binary = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a - b END.");
+    {
+        // A row with too few integers.
+        BatchServer server({binary});
+        std::istringstream in("1 2\n3\n");
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+    }
+    {
+        // Not an integer.
+        BatchServer server({binary});
+        std::istringstream in("1 2x\n");
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+    }
+    {
+        // The rows before a malformed one in the same batch are still written.
+        BatchServer server({binary});
+        std::istringstream in("6 3\n5 1\n1 x\n7 7\n");
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+        EXPECT_EQ(out.str(), "3\n4\n");
+        EXPECT_EQ(server.GetStatistics().rows, 2u);
+    }
+    {
+        // Different numbers of parameters.
+        BatchServer server({binary, jit.RegisterFunction("PARAM a; BEGIN RETURN a END.")});
+        std::istringstream in("1 2\n");
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+    }
+    {
+        // A compilation error.
+        BatchServer server({jit.RegisterFunction("PARAM a; BEGIN RETURN b END.")});
+        std::istringstream in("1\n");
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+    }
+    {
+        // A truncated record.
+        BatchServer::Options options;
+        options.format = BatchServer::Format::Binary;
+        BatchServer server({binary}, options);
+        // A complete record followed by a truncated one.
+        std::istringstream in(std::string(16 + 12, '\0'));
+        std::ostringstream out;
+        EXPECT_FALSE(server.Serve(in, out));
+        EXPECT_EQ(out.str().size(), 2 * sizeof(int64_t));
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
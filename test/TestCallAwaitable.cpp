@@ -0,0 +1,53 @@
+#include "jit/CallAwaitable.hpp"
+#include <exception>
+#include <future>
+#include <optional>
+#include <utility>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+#if defined(__cpp_impl_coroutine)
+namespace {
+//---------------------------------------------------------------------------
+/// A coroutine, which runs to its end without being awaited.
+struct DetachedCoroutine {
+    struct promise_type {
+        DetachedCoroutine get_return_object() { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+//---------------------------------------------------------------------------
+/// Divide twice in a row, the second time by zero.
+DetachedCoroutine DivideTwice(FunctionHandle function, std::promise<std::pair<std::optional<int64_t>, std::optional<int64_t>>>& done) {
+    // The arguments are named: gcc 12 fails on an initializer list inside a co_await expression.
+    const std::vector<int64_t> first_arguments = {42, 5};
+    const std::optional<int64_t> first = co_await Await(function, first_arguments);
+    const std::vector<int64_t> second_arguments = {first.value_or(0), 0};
+    const std::optional<int64_t> second = co_await Await(function, second_arguments);
+    done.set_value({first, second});
+}
+//---------------------------------------------------------------------------
+} // namespace
+//---------------------------------------------------------------------------
+TEST(CallAwaitable, Coroutine) {
+    JIT jit;
+    auto func = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    std::promise<std::pair<std::optional<int64_t>, std::optional<int64_t>>> done;
+    auto results = done.get_future();
+    DivideTwice(func, done);
+    const auto [first, second] = results.get();
+    EXPECT_EQ(first, 8);
+    EXPECT_EQ(second, std::nullopt);
+    EXPECT_EQ(func.GetStatistics().calls, 2u);
+}
+#else
+TEST(CallAwaitable, Coroutine) { GTEST_FAIL() << "Compiled without coroutines"; }
+#endif
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,70 @@
+#include "jit/CodeMemory.hpp"
+#include <cstring>
+#include <set>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(CodeMemory, Allocate) {
+    CodeMemory code_memory(size_t(64) << 10);
+    std::set<uint8_t*> allocations;
+    for (size_t i = 0; i < 1000; i++) {
+        uint8_t* code = code_memory.Allocate(1 + i % 100, i % 2 ? 16 : 64);
+        ASSERT_NE(code, nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(code) % (i % 2 ? 16 : 64), 0u);
+        EXPECT_TRUE(allocations.insert(code).second);
+        std::memset(code, 0xC3, 1 + i % 100);
+    }
+    // Many small functions share a few regions.
+    const auto statistics = code_memory.GetStatistics();
+    EXPECT_EQ(statistics.allocations, 1000u);
+    EXPECT_LE(statistics.regions, 2u);
+    // Larger than a region.
+    uint8_t* large = code_memory.Allocate(size_t(1) << 20);
+    ASSERT_NE(large, nullptr);
+    std::memset(large, 0xC3, size_t(1) << 20);
+}
+//---------------------------------------------------------------------------
+TEST(CodeMemory, Reuse) {
+    CodeMemory code_memory(size_t(64) << 10);
+    uint8_t* a = code_memory.Allocate(100);
+    uint8_t* b = code_memory.Allocate(100);
+    uint8_t* c = code_memory.Allocate(100);
+    code_memory.Free(b);
+    EXPECT_EQ(code_memory.Allocate(50), b);
+    code_memory.Free(a);
+    code_memory.Free(b);
+    // The freed neighbours are merged.
+    EXPECT_EQ(code_memory.Allocate(200), a);
+    code_memory.Free(c);
+    const auto statistics = code_memory.GetStatistics();
+    EXPECT_EQ(statistics.allocations, 1u);
+    EXPECT_EQ(statistics.regions, 1u);
+}
+//---------------------------------------------------------------------------
+TEST(CodeMemory, Protection) {
+    CodeMemory code_memory(CodeMemory::default_region_size, true);
+    EXPECT_FALSE(code_memory.IsExecutable());
+    uint8_t* code = code_memory.Allocate(16);
+    ASSERT_NE(code, nullptr);
+    // The first allocation starts the region, which is aligned for huge pages.
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(code) % CodeMemory::huge_page_size, 0u);
+#if defined(__x86_64__)
+    // mov rax, 42; ret
+    const uint8_t stub[] = {0x48, 0xC7, 0xC0, 0x2A, 0x00, 0x00, 0x00, 0xC3};
+    std::memcpy(code, stub, sizeof(stub));
+#endif
+    ASSERT_TRUE(code_memory.MakeExecutable());
+    EXPECT_TRUE(code_memory.IsExecutable());
+#if defined(__x86_64__)
+    auto function = reinterpret_cast<int64_t (*)()>(code);
+    EXPECT_EQ(function(), 42);
+#endif
+    // Flipping to the current state is free.
+    ASSERT_TRUE(code_memory.MakeExecutable());
+    ASSERT_TRUE(code_memory.MakeWritable());
+    EXPECT_EQ(code_memory.GetStatistics().protection_changes, 2u);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+#include "jit/ColumnEvaluator.hpp"
+#include "util/MappedFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(ColumnEvaluator, Memory) {
+    JIT jit;
+    auto function = jit.RegisterFunction("PARAM a, b; VAR c; BEGIN c := a - b; RETURN a * b / c END.");
+    const size_t rows = 100000;
+    std::vector<int64_t> a(rows);
+    std::vector<int64_t> b(rows);
+    for (size_t r = 0; r < rows; r++) {
+        a[r] = static_cast<int64_t>(r % 1000);
+        b[r] = static_cast<int64_t>(r % 997);
+    }
+    std::vector<int64_t> results(rows);
+    std::vector<uint8_t> errors(rows);
+    ColumnEvaluator::Options options;
+    options.threads = 4;
+    options.morsel_rows = 4096;
+    ColumnEvaluator evaluator(function, options);
+    ASSERT_TRUE(evaluator.Evaluate({a.data(), b.data()}, rows, results.data(), errors.data()));
+    uint64_t expected_errors = 0;
+    for (size_t r = 0; r < rows; r++) {
+        const bool error = a[r] == b[r];
+        expected_errors += error;
+        ASSERT_EQ(errors[r], error);
+        // The expressions are right-associative.
+        ASSERT_EQ(results[r], error ? 0 : a[r] * (b[r] / (a[r] - b[r])));
+    }
+    const auto& statistics = evaluator.GetStatistics();
+    EXPECT_EQ(statistics.rows, rows);
+    EXPECT_EQ(statistics.morsels, (rows + 4095) / 4096);
+    EXPECT_EQ(statistics.threads, 4u);
+    EXPECT_EQ(statistics.division_by_zero_errors, expected_errors);
+    EXPECT_EQ(function.GetStatistics().calls, rows);
+    // Without an errors column.
+    ASSERT_TRUE(evaluator.Evaluate({a.data(), b.data()}, rows, results.data()));
+    EXPECT_EQ(evaluator.GetStatistics().division_by_zero_errors, expected_errors);
+    // A wrong number of columns.
+    EXPECT_FALSE(evaluator.Evaluate({a.data()}, rows, results.data()));
+}
+//---------------------------------------------------------------------------
+TEST(ColumnEvaluator, Aggregate) {
+    JIT jit;
+    auto function = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    const size_t rows = 100000;
+    std::vector<int64_t> a(rows);
+    std::vector<int64_t> b(rows);
+    for (size_t r = 0; r < rows; r++) {
+        a[r] = static_cast<int64_t>(r) - 50000;
+        b[r] = static_cast<int64_t>(r % 4);
+    }
+    ColumnEvaluator::Options options;
+    options.threads = 3;
+    options.morsel_rows = 1000;
+    ColumnEvaluator evaluator(function, options);
+    Aggregation aggregation;
+    aggregation.histogram_width = 10000;
+    aggregation.histogram_buckets = 2;
+    Aggregates aggregates;
+    ASSERT_TRUE(evaluator.Aggregate({a.data(), b.data()}, rows, aggregation, aggregates));
+    Aggregates expected;
+    expected.histogram.resize(2);
+    for (size_t r = 0; r < rows; r++) {
+        if (b[r] == 0) {
+            continue;
+        }
+        const int64_t value = a[r] / b[r];
+        expected.count++;
+        expected.sum += value;
+        expected.min = std::min(expected.min, value);
+        expected.max = std::max(expected.max, value);
+        expected.histogram[value >= 10000]++;
+    }
+    EXPECT_EQ(aggregates.count, expected.count);
+    EXPECT_EQ(aggregates.errors, rows / 4);
+    EXPECT_EQ(aggregates.sum, expected.sum);
+    EXPECT_EQ(aggregates.min, expected.min);
+    EXPECT_EQ(aggregates.max, expected.max);
+    EXPECT_EQ(aggregates.histogram, expected.histogram);
+    EXPECT_EQ(evaluator.GetStatistics().division_by_zero_errors, rows / 4);
+    EXPECT_EQ(function.GetStatistics().calls, rows);
+    EXPECT_EQ(function.GetStatistics().division_by_zero_errors, rows / 4);
+}
+//---------------------------------------------------------------------------
+TEST(ColumnEvaluator, Files) {
+    const std::string directory = testing::TempDir();
+    const std::vector<std::string> inputs = {directory + "pljit-test-a.col", directory + "pljit-test-b.col"};
+    const std::string output = directory + "pljit-test-result.col";
+    const std::string errors = directory + "pljit-test-errors.col";
+    const size_t rows = 5000;
+    for (size_t c = 0; c < inputs.size(); c++) {
+        std::ofstream file(inputs[c], std::ios::binary);
+        for (size_t r = 0; r < rows; r++) {
+            const auto value = static_cast<int64_t>(c == 0 ? r : r % 10);
+            file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    JIT jit;
+    ColumnEvaluator::Options options;
+    options.threads = 2;
+    options.morsel_rows = 1000;
+    ColumnEvaluator evaluator(jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END."), options);
+    ASSERT_TRUE(evaluator.EvaluateFiles(inputs, output, errors));
+    EXPECT_EQ(evaluator.GetStatistics().division_by_zero_errors, rows / 10);
+    MappedFile results;
+    MappedFile error_flags;
+    ASSERT_TRUE(results.OpenRead(output));
+    ASSERT_TRUE(error_flags.OpenRead(errors));
+    ASSERT_EQ(results.GetSize(), rows * sizeof(int64_t));
+    ASSERT_EQ(error_flags.GetSize(), rows);
+    const auto* values = reinterpret_cast<const int64_t*>(results.GetData());
+    for (size_t r = 0; r < rows; r++) {
+        const auto a = static_cast<int64_t>(r);
+        const auto b = static_cast<int64_t>(r % 10);
+        EXPECT_EQ(error_flags.GetData()[r], b == 0);
+        EXPECT_EQ(values[r], b == 0 ? 0 : a / b);
+    }
+    // Columns of different lengths.
+    {
+        std::ofstream file(inputs[1], std::ios::binary | std::ios::app);
+        file.write("\0\0\0\0\0\0\0\0", 8);
+    }
+    EXPECT_FALSE(evaluator.EvaluateFiles(inputs, output));
+    EXPECT_FALSE(evaluator.EvaluateFiles({directory + "pljit-test-missing.col", inputs[1]}, output));
+    for (auto& path : {inputs[0], inputs[1], output, errors}) {
+        std::remove(path.c_str());
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
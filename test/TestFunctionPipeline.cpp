@@ -0,0 +1,85 @@
+#include "jit/FunctionPipeline.hpp"
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(FunctionPipeline, Chain) {
+    JIT jit;
+    auto first = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a * b - b END.");
+    auto second = jit.RegisterFunction("PARAM y, x; BEGIN RETURN y / x END.");
+    auto third = jit.RegisterFunction("PARAM r, s; VAR t; BEGIN t := s * 2; RETURN r + t END.");
+    FunctionPipeline pipeline(first);
+    pipeline.Then(second, "x").Then(third, "r");
+    ASSERT_EQ(pipeline.GetNumberOfParameters(), 4u);
+
+    std::vector<int64_t> arguments;
+    std::vector<std::optional<int64_t>> expected;
+    for (int64_t a = -3; a <= 3; a++) {
+        for (int64_t b = -2; b <= 2; b++) {
+            const int64_t y = a * 7 + b;
+            const int64_t s = b - a;
+            const int64_t row[] = {a, b, y, s};
+            arguments.insert(arguments.end(), row, row + 4);
+            std::optional<int64_t> result = first(a, b);
+            if (result) { result = second(y, *result); }
+            if (result) { result = third(*result, s); }
+            expected.push_back(result);
+            EXPECT_EQ(pipeline.Call(row, 4), result) << a << " " << b;
+        }
+    }
+    std::vector<int64_t> results(expected.size());
+    std::vector<uint8_t> errors(expected.size());
+    ASSERT_TRUE(pipeline.CallBatch(arguments.data(), expected.size(), results.data(), errors.data()));
+    for (size_t r = 0; r < expected.size(); r++) {
+        EXPECT_EQ(errors[r], !expected[r]);
+        EXPECT_EQ(results[r], expected[r].value_or(0));
+    }
+    const int64_t too_few[] = {1, 2};
+    EXPECT_FALSE(pipeline.Call(too_few, 2));
+}
+//---------------------------------------------------------------------------
+TEST(FunctionPipeline, Folding) {
+    JIT jit;
+    FunctionPipeline pipeline(jit.RegisterFunction("PARAM a; CONST k = 3; BEGIN RETURN k * 2 END."));
+    pipeline.Then(jit.RegisterFunction("PARAM x, y; BEGIN RETURN x * x + y END."), "x");
+    ASSERT_TRUE(pipeline.Compile());
+    // `x * x` is folded into 36 across the functions, and the unused parameter `a` is dropped.
+    using Opcode = Instruction::Opcode;
+    const std::vector<Opcode> expected = {Opcode::Parameter, Opcode::Constant, Opcode::Add, Opcode::Return};
+    const IRFunction* ir = pipeline.GetIR();
+    ASSERT_TRUE(ir);
+    ASSERT_EQ(ir->GetInstructions().size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(ir->GetInstructions()[i].opcode, expected[i]);
+    }
+    EXPECT_EQ(ir->GetInstructions()[1].value, 36);
+    const int64_t arguments[] = {100, 5};
+    EXPECT_EQ(pipeline.Call(arguments, 2), 41);
+}
+//---------------------------------------------------------------------------
+TEST(FunctionPipeline, Errors) {
+    JIT jit;
+    auto reciprocal = jit.RegisterFunction("PARAM a; BEGIN RETURN 1 / a END.");
+    {
+        // A division by zero fails the row, even if the result is not used.
+        FunctionPipeline pipeline(reciprocal);
+        pipeline.Then(jit.RegisterFunction("PARAM x, y; BEGIN RETURN y END."), "x");
+        const int64_t zero[] = {0, 5};
+        const int64_t one[] = {1, 5};
+        EXPECT_FALSE(pipeline.Call(zero, 2));
+        EXPECT_EQ(pipeline.Call(one, 2), 5);
+    }
+    {
+        FunctionPipeline pipeline(reciprocal);
+        pipeline.Then(jit.RegisterFunction("PARAM x; BEGIN RETURN x END."), "z");
+        EXPECT_FALSE(pipeline.Compile());
+    }
+    {
+        FunctionPipeline pipeline(jit.RegisterFunction("PARAM a; BEGIN RETURN b END."));
+        EXPECT_FALSE(pipeline.GetNumberOfParameters());
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,109 @@
+#include "jit/FusedKernel.hpp"
+#include <sstream>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(FusedKernel, Evaluation) {
+    JIT jit;
+    std::vector<FunctionHandle> functions = {jit.RegisterFunction("PARAM a, b, c; BEGIN RETURN a * b + c END."),
+                                             jit.RegisterFunction("PARAM a, b, c; BEGIN RETURN a * b - c END."),
+                                             jit.RegisterFunction("PARAM a, b, c; BEGIN RETURN c / (a - b) END."),
+                                             jit.RegisterFunction("PARAM a, b, c; VAR d; BEGIN d := c / (a - b); RETURN d + a * b END."),
+                                             jit.RegisterFunction("PARAM a, b, c; BEGIN RETURN (a * b) / 2 END."),
+                                             jit.RegisterFunction("PARAM x, y, z; BEGIN RETURN x * y END.")};
+    FusedKernel kernel(functions);
+    ASSERT_TRUE(kernel.Compile());
+    ASSERT_EQ(kernel.GetNumberOfFunctions(), functions.size());
+    ASSERT_EQ(kernel.GetNumberOfParameters(), 3u);
+
+    // The parameters, `a * b` and `c / (a - b)` are computed once.
+    size_t separate_instructions = 0;
+    for (auto& function : functions) {
+        JIT::MemoryUsage usage = function.GetMemoryUsage();
+        separate_instructions += (usage.code - sizeof(IRFunction)) / sizeof(Instruction) - 1;
+    }
+    const FusedIRFunction* ir = kernel.GetIR();
+    ASSERT_TRUE(ir);
+    EXPECT_EQ(ir->GetInstructions().size(), 11u);
+    EXPECT_LT(ir->GetInstructions().size(), separate_instructions);
+    ASSERT_EQ(ir->GetOutputs().size(), functions.size());
+    EXPECT_EQ(ir->GetOutputs()[1].divisors.size(), 0u);
+    EXPECT_EQ(ir->GetOutputs()[2].divisors, ir->GetOutputs()[3].divisors);
+    // The division by the constant 2 cannot fail.
+    EXPECT_EQ(ir->GetOutputs()[4].divisors.size(), 0u);
+    // `x * y` is the `a * b` of the other functions.
+    EXPECT_EQ(ir->GetInstructions()[ir->GetOutputs()[5].value].opcode, Instruction::Opcode::Mul);
+    EXPECT_EQ(ir->GetInstructions()[ir->GetOutputs()[0].value].left, ir->GetOutputs()[5].value);
+    std::ostringstream out;
+    ir->Print(out);
+    EXPECT_NE(out.str().find("out 3 = %"), std::string::npos);
+
+    // More rows than a block, with a division by zero in every 7th row.
+    const size_t rows = 1000;
+    std::vector<int64_t> arguments;
+    std::vector<std::vector<int64_t>> columns(3);
+    for (size_t r = 0; r < rows; r++) {
+        const auto i = static_cast<int64_t>(r);
+        const int64_t row[] = {i % 7, r % 7 ? -i : 0, i * 3 - 500};
+        for (size_t p = 0; p < 3; p++) {
+            arguments.push_back(row[p]);
+            columns[p].push_back(row[p]);
+        }
+    }
+    std::vector<std::vector<int64_t>> results(functions.size(), std::vector<int64_t>(rows));
+    std::vector<std::vector<uint8_t>> errors(functions.size(), std::vector<uint8_t>(rows));
+    std::vector<int64_t*> result_columns;
+    std::vector<uint8_t*> error_columns;
+    for (size_t f = 0; f < functions.size(); f++) {
+        result_columns.push_back(results[f].data());
+        error_columns.push_back(errors[f].data());
+    }
+    auto check = [&]() {
+        for (size_t f = 0; f < functions.size(); f++) {
+            for (size_t r = 0; r < rows; r++) {
+                const std::optional<int64_t> expected = functions[f].Call(&arguments[r * 3], 3);
+                ASSERT_EQ(errors[f][r], !expected) << "function " << f << ", row " << r;
+                EXPECT_EQ(results[f][r], expected.value_or(0)) << "function " << f << ", row " << r;
+            }
+        }
+    };
+    ASSERT_TRUE(kernel.EvaluateBatch(arguments.data(), rows, result_columns.data(), error_columns.data()));
+    check();
+    EXPECT_EQ(functions[2].GetStatistics().calls, rows * 2);
+    EXPECT_EQ(functions[2].GetStatistics().division_by_zero_errors, (rows + 6) / 7 * 2);
+    EXPECT_EQ(functions[0].GetStatistics().division_by_zero_errors, 0u);
+
+    const int64_t* column_pointers[] = {columns[0].data(), columns[1].data(), columns[2].data()};
+    for (auto& column : results) {
+        std::fill(column.begin(), column.end(), -1);
+    }
+    ASSERT_TRUE(kernel.EvaluateColumns(column_pointers, rows, result_columns.data(), error_columns.data()));
+    check();
+}
+//---------------------------------------------------------------------------
+TEST(FusedKernel, Errors) {
+    JIT jit;
+    {
+        FusedKernel kernel({});
+        EXPECT_FALSE(kernel.Compile());
+    }
+    {
+        FusedKernel kernel({jit.RegisterFunction("PARAM a; BEGIN RETURN a END."), jit.RegisterFunction("PARAM a, b; BEGIN RETURN a END.")});
+        EXPECT_FALSE(kernel.Compile());
+        EXPECT_FALSE(kernel.GetNumberOfParameters());
+    }
+    {
+        FusedKernel kernel({jit.RegisterFunction("PARAM a; BEGIN RETURN b END.")});
+        int64_t result = 0;
+        uint8_t error = 0;
+        int64_t* results[] = {&result};
+        uint8_t* errors[] = {&error};
+        const int64_t argument = 1;
+        EXPECT_FALSE(kernel.EvaluateBatch(&argument, 1, results, errors));
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,257 @@
+#include "parser/Parser.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "jit/IR.hpp"
+#include "optimization/PassManager.hpp"
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(IR, Lowering) {
+    const std::string code = "PARAM a, b;\n"
+                             "VAR c;\n"
+                             "CONST d = 3;\n"
+                             "BEGIN\n"
+                             "    c := a * d;\n"
+                             "    c := c + a * d;\n"
+                             "    RETURN -c / b;\n"
+                             "    c := 1\n"
+                             "END.\n";
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    ASSERT_TRUE(parse_tree);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    ASSERT_TRUE(ast);
+    IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+    const IRFunction function = builder.Build(*ast);
+    // `a * d` is computed once.
+    using Opcode = Instruction::Opcode;
+    const std::vector<Opcode> expected = {Opcode::Parameter, Opcode::Constant, Opcode::Mul, Opcode::Add, Opcode::Negate, Opcode::Parameter, Opcode::Div, Opcode::Return};
+    ASSERT_EQ(function.GetInstructions().size(), expected.size());
+    for (size_t i = 0; i < expected.size(); i++) {
+        EXPECT_EQ(function.GetInstructions()[i].opcode, expected[i]);
+    }
+    EXPECT_EQ(function.GetNumberOfRegisters(), 7u);
+    EXPECT_EQ(function.GetNumberOfParameters(), 2u);
+    for (int64_t a = -5; a <= 5; a++) {
+        for (int64_t b = -2; b <= 2; b++) {
+            const int64_t arguments[] = {a, b};
+            EXPECT_EQ(function.Evaluate(arguments), b == 0 ? std::nullopt : std::optional<int64_t>(-(a * 3 + a * 3) / b));
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(IR, Evaluation) {
+    // The IR gives the same results as the AST.
+    const std::vector<std::string> codes = {
+        "BEGIN RETURN 12 * (8 - 5) END.",
+        "PARAM a; VAR b, c, d; CONST e = 1; BEGIN b := 1 + 2; c := b + e; d := b + c + e; RETURN a * d + 1 * 2 - 2 / 1 END.",
+        "PARAM a, b; VAR c; BEGIN c := a; a := b; b := c; RETURN a - b END.",
+        "PARAM a, b; VAR c; BEGIN c := 1 / b; RETURN a END.",
+    };
+    PassManager pass_manager;
+    for (auto& code : codes) {
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        pass_manager.Run("O3", *ast, semantic_analyzer.GetSymbolTable());
+        IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+        const IRFunction function = builder.Build(*ast);
+        for (int64_t a = -3; a <= 3; a++) {
+            for (int64_t b = -3; b <= 3; b++) {
+                const int64_t arguments[] = {a, b};
+                EvaluationContext ec(semantic_analyzer.GetSymbolTable());
+                const auto& parameters = semantic_analyzer.GetParameters();
+                for (size_t i = 0; i < parameters.size(); i++) {
+                    ec.GetValueTable().find(parameters[i])->second.SetValue(arguments[i]);
+                }
+                const int64_t value = ast->Evaluate(ec);
+                const std::optional<int64_t> expected = ec.GetDivisionByZero() ? std::nullopt : std::optional<int64_t>(value);
+                EXPECT_EQ(function.Evaluate(arguments), expected) << code;
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(IR, Print) {
+    using Opcode = Instruction::Opcode;
+    const IRFunction function({{Opcode::Parameter, 0, 0, 0, 0},
+                               {Opcode::Constant, 1, 0, 0, 7},
+                               {Opcode::Mul, 2, 0, 1, 0},
+                               {Opcode::Negate, 3, 2, 0, 0},
+                               {Opcode::Return, 0, 3, 0, 0}},
+                              4, 1);
+    std::ostringstream out;
+    function.Print(out);
+    EXPECT_EQ(out.str(), "%0 = param 0\n"
+                         "%1 = const 7\n"
+                         "%2 = mul %0, %1\n"
+                         "%3 = neg %2\n"
+                         "ret %3\n");
+}
+//---------------------------------------------------------------------------
+TEST(IR, EvaluateBatch) {
+    const std::string code = "PARAM a, b;\n"
+                             "VAR c;\n"
+                             "BEGIN\n"
+                             "    c := a * 2;\n"
+                             "    RETURN c - 100 / b\n"
+                             "END.\n";
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    ASSERT_TRUE(parse_tree);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    ASSERT_TRUE(ast);
+    IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+    const IRFunction function = builder.Build(*ast);
+    // More rows than a block, with a partial last block.
+    const size_t rows = IRFunction::batch_block_size * 2 + 17;
+    std::vector<int64_t> arguments;
+    for (size_t r = 0; r < rows; r++) {
+        arguments.push_back(static_cast<int64_t>(r));
+        arguments.push_back(static_cast<int64_t>(r % 7) - 3);
+    }
+    std::vector<int64_t> results(rows);
+    std::vector<uint8_t> errors(rows);
+    size_t expected_errors = 0;
+    EXPECT_EQ(function.EvaluateBatch(arguments.data(), rows, results.data(), errors.data()), rows / 7 + 1);
+    for (size_t r = 0; r < rows; r++) {
+        const std::optional<int64_t> expected = function.Evaluate(&arguments[r * 2]);
+        EXPECT_EQ(errors[r], !expected);
+        EXPECT_EQ(results[r], expected.value_or(0));
+        expected_errors += !expected;
+    }
+    EXPECT_EQ(expected_errors, rows / 7 + 1);
+}
+//---------------------------------------------------------------------------
+TEST(IR, Aggregate) {
+    const std::string code = "PARAM a, b; BEGIN RETURN a / b END.";
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    ASSERT_TRUE(parse_tree);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    ASSERT_TRUE(ast);
+    IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+    const IRFunction function = builder.Build(*ast);
+    const size_t rows = IRFunction::batch_block_size * 3 + 5;
+    std::vector<int64_t> arguments;
+    for (size_t r = 0; r < rows; r++) {
+        arguments.push_back(static_cast<int64_t>(r) - 300);
+        arguments.push_back(static_cast<int64_t>(r % 5) - 1);
+    }
+    Aggregation aggregation;
+    aggregation.histogram_lower = -100;
+    aggregation.histogram_width = 50;
+    aggregation.histogram_buckets = 6;
+    // The first rows and the other rows are aggregated separately and merged.
+    Aggregates aggregates;
+    function.AggregateBatch(arguments.data(), 100, aggregation, aggregates);
+    Aggregates rest;
+    function.AggregateBatch(&arguments[200], rows - 100, aggregation, rest);
+    aggregates.Merge(rest);
+
+    Aggregates expected;
+    expected.histogram.resize(6);
+    for (size_t r = 0; r < rows; r++) {
+        const std::optional<int64_t> value = function.Evaluate(&arguments[r * 2]);
+        if (!value) {
+            expected.errors++;
+            continue;
+        }
+        expected.count++;
+        expected.sum += *value;
+        expected.min = std::min(expected.min, *value);
+        expected.max = std::max(expected.max, *value);
+        expected.histogram[std::clamp<int64_t>((*value + 100) / 50 - (*value < -100), 0, 5)]++;
+    }
+    EXPECT_EQ(aggregates.count, expected.count);
+    EXPECT_EQ(aggregates.errors, rows / 5 + 1);
+    EXPECT_EQ(aggregates.errors, expected.errors);
+    EXPECT_EQ(aggregates.sum, expected.sum);
+    EXPECT_EQ(aggregates.min, expected.min);
+    EXPECT_EQ(aggregates.max, expected.max);
+    EXPECT_EQ(aggregates.histogram, expected.histogram);
+}
+//---------------------------------------------------------------------------
+/// Lower a function without optimizations.
+static IRFunction Lower(const std::string& code) {
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(parser.ParseFunctionDefinition());
+    EXPECT_TRUE(ast);
+    IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+    return builder.Build(*ast);
+}
+//---------------------------------------------------------------------------
+TEST(IR, InvariantDivision) {
+    const IRFunction function = Lower("PARAM a, b; BEGIN RETURN a / b END.");
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    std::vector<int64_t> numerators = {0, 1, -1, 2, -2, 3, -3, 7, -7, 1000, -1000, max, max - 1, min, min + 1, min / 2, max / 2};
+    std::vector<int64_t> divisors = {1, -1, 2, -2, 3, -3, 5, 6, 7, -7, 10, 64, -64, 641, 1000, 1 << 20, (1 << 20) + 1, max, max - 1, min, min + 1, min / 2, max / 3};
+    uint64_t state = 42;
+    for (size_t i = 0; i < 200; i++) {
+        // A xorshift generator, shifted for small and large values.
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        numerators.push_back(static_cast<int64_t>(state) >> (i % 60));
+        divisors.push_back(static_cast<int64_t>(state * 0x9E3779B97F4A7C15ull) >> (i % 62));
+    }
+    const std::vector<bool> scalar_parameters = {false, true};
+    std::vector<int64_t> results(numerators.size());
+    std::vector<uint8_t> errors(numerators.size());
+    for (int64_t divisor : divisors) {
+        if (divisor == 0) { continue; }
+        const int64_t* columns[] = {numerators.data(), &divisor};
+        EXPECT_EQ(function.EvaluateColumns(columns, numerators.size(), results.data(), errors.data(), &scalar_parameters), 0u);
+        for (size_t r = 0; r < numerators.size(); r++) {
+            if (numerators[r] == min && divisor == -1) { continue; }  // Overflows.
+            ASSERT_EQ(results[r], numerators[r] / divisor) << numerators[r] << " / " << divisor;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(IR, ScalarParameters) {
+    const IRFunction function = Lower("PARAM x, rate, scale; VAR f; BEGIN f := rate * scale + 1; RETURN x * f / (scale - 2) - 1000 / x END.");
+    const size_t rows = IRFunction::batch_block_size + 100;
+    std::vector<int64_t> x(rows);
+    for (size_t r = 0; r < rows; r++) {
+        x[r] = static_cast<int64_t>(r) - 50;
+    }
+    const std::vector<bool> scalar_parameters = {false, true, true};
+    std::vector<int64_t> results(rows);
+    std::vector<uint8_t> errors(rows);
+    for (int64_t scale : {-3, 2, 5}) {
+        const int64_t rate = 7;
+        const int64_t* columns[] = {x.data(), &rate, &scale};
+        const size_t number_of_errors = function.EvaluateColumns(columns, rows, results.data(), errors.data(), &scalar_parameters);
+        size_t expected_errors = 0;
+        for (size_t r = 0; r < rows; r++) {
+            const int64_t arguments[] = {x[r], rate, scale};
+            const std::optional<int64_t> expected = function.Evaluate(arguments);
+            ASSERT_EQ(errors[r], !expected);
+            ASSERT_EQ(results[r], expected.value_or(0));
+            expected_errors += !expected;
+        }
+        // A scale of 2 fails all rows.
+        EXPECT_EQ(number_of_errors, scale == 2 ? rows : 1);
+        EXPECT_EQ(number_of_errors, expected_errors);
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -1,4 +1,7 @@
 #include "jit/JIT.hpp"
+#include "util/AllocationTracker.hpp"
+#include <atomic>
+#include <future>
 #include <thread>
 #include <vector>
 #include <gtest/gtest.h>
@@ -164,5 +167,476 @@ TEST(JIT, MultithreadingParameterTest) {
     }
 }
 //---------------------------------------------------------------------------
+TEST(JIT, ParameterOrderTest) {
+    const std::string code = "PARAM a, b, c;\n"
+                             "BEGIN\n"
+                             "    RETURN (a - b) * 100 + c\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    EXPECT_EQ(func(7, 3, -5), (7 - 3) * 100 + -5);
+    EXPECT_EQ(func(3, 7, 5), (3 - 7) * 100 + 5);
+    EXPECT_EQ(func(1, 2), std::nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, SpecializeTest0) {
+    const std::string code = "PARAM rate, x;\n"
+                             "VAR scale;\n"
+                             "CONST base = 5;\n"
+                             "BEGIN\n"
+                             "    scale := rate * 100 + base;\n"
+                             "    RETURN x * scale - rate\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    auto specialized = jit.Specialize(func, {{"rate", 3}});
+    ASSERT_TRUE(specialized);
+    for (int64_t x = -50; x < 50; x++) {
+        EXPECT_EQ((*specialized)(x), x * (3 * 100 + 5) - 3);
+        EXPECT_EQ((*specialized)(x), func(3, x));
+    }
+}
+//---------------------------------------------------------------------------
+TEST(JIT, SpecializeTest1) {
+    const std::string code = "PARAM a, b, c;\n"
+                             "BEGIN\n"
+                             "    a := a + b;\n"
+                             "    RETURN a / c\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    auto specialized_b = jit.Specialize(func, {{"b", 10}});
+    ASSERT_TRUE(specialized_b);
+    EXPECT_EQ((*specialized_b)(2, 4), (2 + 10) / 4);
+    // A specialization of a specialized function.
+    auto specialized_bc = jit.Specialize(*specialized_b, {{"c", 0}});
+    ASSERT_TRUE(specialized_bc);
+    EXPECT_EQ((*specialized_bc)(2), std::nullopt);
+    // All parameters bound: the function folds to a constant.
+    auto specialized_abc = jit.Specialize(*specialized_b, {{"a", 2}, {"c", 3}});
+    ASSERT_TRUE(specialized_abc);
+    EXPECT_EQ((*specialized_abc)(), (2 + 10) / 3);
+    // A bound parameter cannot be bound again.
+    EXPECT_FALSE(jit.Specialize(*specialized_b, {{"b", 5}}));
+    EXPECT_FALSE(jit.Specialize(*specialized_b, {{"a", 1}, {"b", 5}}));
+    EXPECT_EQ((*specialized_b)(2, 4), (2 + 10) / 4);
+    // The original function is not changed.
+    EXPECT_EQ(func(1, 2, 3), (1 + 2) / 3);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, SpecializeTest2) {
+    const std::string code = "PARAM a;\n"
+                             "VAR b;\n"
+                             "BEGIN\n"
+                             "    b := a;\n"
+                             "    RETURN b\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    // Only parameters can be bound.
+    EXPECT_FALSE(jit.Specialize(func, {{"b", 1}}));
+    EXPECT_FALSE(jit.Specialize(func, {{"z", 1}}));
+    // A compilation error.
+    auto broken = jit.RegisterFunction("PARAM a, b; BEGIN RETURN c END.");
+    EXPECT_FALSE(jit.Specialize(broken, {{"a", 1}}));
+    EXPECT_EQ(func(1), 1);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, ConstantFunctionTest) {
+    const std::string code = "PARAM a, b;\n"
+                             "VAR c;\n"
+                             "CONST d = 7;\n"
+                             "BEGIN\n"
+                             "    c := d * 6;\n"
+                             "    RETURN c\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    for (int64_t param = 0; param < 10; param++) {
+        EXPECT_EQ(func(param, -param), 42);
+    }
+    // The arguments are still checked.
+    EXPECT_EQ(func(1), std::nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, ConstantFunctionDivisionTest) {
+    const std::string code = "PARAM a;\n"
+                             "VAR b;\n"
+                             "BEGIN\n"
+                             "    b := 1 / a;\n"
+                             "    RETURN 42\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    EXPECT_EQ(func(1), 42);
+    EXPECT_EQ(func(0), std::nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, OptimizationLevelTest) {
+    const std::string code = "PARAM a, b;\n"
+                             "VAR c, d;\n"
+                             "CONST e = 3;\n"
+                             "BEGIN\n"
+                             "    c := e * 2;\n"
+                             "    d := c / b;\n"
+                             "    c := a - c;\n"
+                             "    RETURN c * d;\n"
+                             "    d := 0\n"
+                             "END.\n";
+    JIT jit;
+    ASSERT_TRUE(jit.AddPipeline("fold", {"constant-propagation"}));
+    std::vector<FunctionHandle> functions = {
+        jit.RegisterFunction(code, OptimizationLevel::O0),
+        jit.RegisterFunction(code, OptimizationLevel::O1),
+        jit.RegisterFunction(code, OptimizationLevel::O2),
+        jit.RegisterFunction(code, OptimizationLevel::O3),
+        jit.RegisterFunction(code, "fold"),
+    };
+    for (auto& func : functions) {
+        for (int64_t b = -3; b <= 3; b++) {
+            EXPECT_EQ(func(5, b), b == 0 ? std::nullopt : std::optional<int64_t>((5 - 6) * (6 / b)));
+        }
+    }
+    auto unknown = jit.RegisterFunction(code, "unknown");
+    EXPECT_EQ(unknown(1, 1), std::nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, MultipleDivisionByZeroTest) {
+    const std::string code = "PARAM a, b;\n"
+                             "VAR c;\n"
+                             "BEGIN\n"
+                             "    c := a / b + 1 / b;\n"
+                             "    c := c / b;\n"
+                             "    RETURN c\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code, OptimizationLevel::O0);
+    EXPECT_EQ(func(4, 2), 1);
+    EXPECT_EQ(func(4, 0), std::nullopt);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, StatisticsTest) {
+    const std::string code = "PARAM a, b;\n"
+                             "BEGIN\n"
+                             "    RETURN a / b\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    auto constant = jit.RegisterFunction("BEGIN RETURN 1 END.");
+    EXPECT_EQ(func.GetStatistics().tier, Tier::Uncompiled);
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&func, t]() {
+            for (int64_t i = 0; i < 100; i++) {
+                func(i, (i + t) % 10);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(constant(), 1);
+    const auto statistics = func.GetStatistics();
+    EXPECT_EQ(statistics.calls, 400u);
+    EXPECT_EQ(statistics.division_by_zero_errors, 40u);
+    EXPECT_GE(statistics.total_evaluation_ns, statistics.max_evaluation_ns);
+    EXPECT_GT(statistics.compile_ns[static_cast<size_t>(CompilePhase::Parse)], 0u);
+    EXPECT_GT(statistics.compile_ns[static_cast<size_t>(CompilePhase::SemanticAnalysis)], 0u);
+    EXPECT_EQ(statistics.tier, Tier::Interpreted);
+    const auto all = jit.GetStatistics();
+    ASSERT_EQ(all.size(), 2u);
+    EXPECT_EQ(all[0].calls, 400u);
+    EXPECT_EQ(all[1].calls, 1u);
+    EXPECT_EQ(all[1].tier, Tier::Constant);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, LockStatisticsTest) {
+    JIT jit;
+    auto func = jit.RegisterFunction("PARAM a; BEGIN RETURN a * 2 END.");
+    std::vector<std::thread> threads;
+    for (int64_t t = 0; t < 4; t++) {
+        threads.emplace_back([&func, t]() {
+            for (int64_t i = 0; i < 100; i++) {
+                EXPECT_EQ(func(t + i), 2 * (t + i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    const auto statistics = jit.GetLockStatistics();
+    // Every call locks both mutexes once.
+    EXPECT_GE(statistics.register_mutex.acquisitions, 400u);
+    EXPECT_EQ(statistics.function_mutexes.acquisitions, 400u);
+    EXPECT_LE(statistics.register_mutex.contentions, statistics.register_mutex.acquisitions);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, MemoryUsageTest) {
+    JIT jit;
+    auto small = jit.RegisterFunction("PARAM a; BEGIN RETURN a END.");
+    auto large = jit.RegisterFunction("PARAM a, b; VAR c, d;\n"
+                                      "BEGIN\n"
+                                      "    c := a * b + a - b;\n"
+                                      "    d := c * c - a * (b + c);\n"
+                                      "    RETURN c + d * a - b\n"
+                                      "END.\n");
+    // Uncompiled functions only retain their source code.
+    EXPECT_EQ(small.GetMemoryUsage().ast, 0u);
+    EXPECT_GT(small.GetMemoryUsage().source, 0u);
+    // The call counters are allocated by the first call.
+    EXPECT_EQ(small.GetMemoryUsage().statistics, 0u);
+    EXPECT_LT(small.GetMemoryUsage().GetTotal(), 512u);
+    EXPECT_EQ(small(1), 1);
+    EXPECT_GT(small.GetMemoryUsage().statistics, 0u);
+    EXPECT_TRUE(large(1, 2));
+    const auto small_usage = small.GetMemoryUsage();
+    const auto large_usage = large.GetMemoryUsage();
+    EXPECT_GT(large_usage.source, small_usage.source);
+    EXPECT_GT(large_usage.ast, small_usage.ast);
+    EXPECT_GT(large_usage.frame_template, small_usage.frame_template);
+    EXPECT_EQ(large_usage.result_cache, 0u);
+    EXPECT_GT(large_usage.code, small_usage.code);
+    ASSERT_TRUE(large.EnableResultCache(64));
+    const auto cached_usage = large.GetMemoryUsage();
+    EXPECT_GT(cached_usage.result_cache, 0u);
+    EXPECT_EQ(cached_usage.GetTotal(), large_usage.GetTotal() + cached_usage.result_cache);
+    auto total = cached_usage;
+    total += small_usage;
+    EXPECT_EQ(jit.GetMemoryUsage().GetTotal(), total.GetTotal());
+}
+//---------------------------------------------------------------------------
+TEST(JIT, CompileAllocationsTest) {
+    if (!AllocationTracker::IsEnabled()) {
+        GTEST_SKIP() << "built without PLJIT_TRACK_ALLOCATIONS";
+    }
+    JIT jit;
+    auto func = jit.RegisterFunction("PARAM a; VAR b; BEGIN b := a * 2; RETURN b + 1 END.");
+    EXPECT_EQ(func(1), 3);
+    const auto statistics = func.GetStatistics();
+    for (size_t phase = 0; phase < FunctionStatistics::number_of_phases; phase++) {
+        EXPECT_GT(statistics.compile_allocations[phase], 0u);
+        EXPECT_GT(statistics.compile_peak_bytes[phase], 0u);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(JIT, CallBatchTest) {
+    JIT jit;
+    auto func = jit.RegisterFunction("PARAM a, b; VAR c; BEGIN c := a * b; RETURN c / (a - b) END.");
+    auto constant = jit.RegisterFunction("PARAM a; BEGIN RETURN 7 END.");
+    auto invalid = jit.RegisterFunction("PARAM a; BEGIN RETURN b END.");
+    EXPECT_EQ(func.GetNumberOfParameters(), 2u);
+    EXPECT_EQ(invalid.GetNumberOfParameters(), std::nullopt);
+    std::vector<int64_t> arguments;
+    for (int64_t a = -10; a <= 10; a++) {
+        for (int64_t b = -10; b <= 10; b++) {
+            arguments.push_back(a);
+            arguments.push_back(b);
+        }
+    }
+    const size_t rows = arguments.size() / 2;
+    std::vector<int64_t> results(rows);
+    std::vector<uint8_t> errors(rows);
+    ASSERT_TRUE(func.CallBatch(arguments.data(), rows, results.data(), errors.data()));
+    for (size_t r = 0; r < rows; r++) {
+        const std::optional<int64_t> expected = func(arguments[r * 2], arguments[r * 2 + 1]);
+        EXPECT_EQ(errors[r], !expected);
+        EXPECT_EQ(results[r], expected.value_or(0));
+    }
+    const auto statistics = func.GetStatistics();
+    EXPECT_EQ(statistics.calls, 2 * rows);
+    EXPECT_EQ(statistics.division_by_zero_errors, 2u * 21u);
+    ASSERT_TRUE(constant.CallBatch(arguments.data(), rows, results.data(), errors.data()));
+    EXPECT_EQ(results[rows - 1], 7);
+    EXPECT_EQ(errors[rows - 1], 0);
+    EXPECT_FALSE(invalid.CallBatch(arguments.data(), rows, results.data(), errors.data()));
+}
+//---------------------------------------------------------------------------
+TEST(JIT, SelectTest) {
+    JIT jit;
+    // True for the rows with a remainder of a / b smaller than 2, fails for b = 0.
+    auto predicate = jit.RegisterFunction("PARAM a, b; VAR q; BEGIN q := a / b; RETURN (a - q * b) / 2 END.");
+    std::vector<int64_t> a;
+    std::vector<int64_t> b;
+    std::vector<int64_t> arguments;
+    for (int64_t i = 0; i < 1000; i++) {
+        a.push_back(i * 7 + 3);
+        b.push_back(i % 6);
+        arguments.push_back(a.back());
+        arguments.push_back(b.back());
+    }
+    const size_t rows = a.size();
+    std::vector<uint32_t> expected;
+    for (size_t r = 0; r < rows; r++) {
+        const std::optional<int64_t> result = predicate(a[r], b[r]);
+        if (result && *result) {
+            expected.push_back(static_cast<uint32_t>(r));
+        }
+    }
+    ASSERT_FALSE(expected.empty());
+    std::vector<uint32_t> selection(rows);
+    size_t selected = 0;
+    ASSERT_TRUE(predicate.Select(arguments.data(), rows, selection.data(), selected));
+    selection.resize(selected);
+    EXPECT_EQ(selection, expected);
+
+    const int64_t* columns[] = {a.data(), b.data()};
+    selection.assign(rows, 0);
+    ASSERT_TRUE(predicate.SelectColumns(columns, rows, selection.data(), selected));
+    selection.resize(selected);
+    EXPECT_EQ(selection, expected);
+    EXPECT_EQ(predicate.GetStatistics().division_by_zero_errors, (rows + 5) / 6 * 3);
+
+    auto invalid = jit.RegisterFunction("PARAM a; BEGIN RETURN b END.");
+    EXPECT_FALSE(invalid.Select(arguments.data(), 1, selection.data(), selected));
+}
+//---------------------------------------------------------------------------
+TEST(JIT, ScalarParametersTest) {
+    JIT jit;
+    auto func = jit.RegisterFunction("PARAM amount, rate; BEGIN RETURN amount * 100 / rate END.");
+    const std::vector<int64_t> amounts = {-250, 0, 13, 99999};
+    const int64_t rate = 7;
+    const int64_t* columns[] = {amounts.data(), &rate};
+    const std::vector<bool> scalar_parameters = {false, true};
+    std::vector<int64_t> results(amounts.size());
+    std::vector<uint8_t> errors(amounts.size());
+    ASSERT_TRUE(func.CallColumns(columns, amounts.size(), results.data(), errors.data(), &scalar_parameters));
+    for (size_t r = 0; r < amounts.size(); r++) {
+        EXPECT_EQ(errors[r], 0);
+        // The expressions are right-associative.
+        EXPECT_EQ(results[r], amounts[r] * (100 / rate));
+    }
+    size_t selected = 0;
+    std::vector<uint32_t> selection(amounts.size());
+    ASSERT_TRUE(func.SelectColumns(columns, amounts.size(), selection.data(), selected, &scalar_parameters));
+    EXPECT_EQ(selected, 3u);
+    const std::vector<bool> wrong = {true};
+    EXPECT_FALSE(func.CallColumns(columns, amounts.size(), results.data(), errors.data(), &wrong));
+}
+//---------------------------------------------------------------------------
+TEST(JIT, ParallelBatchTest) {
+    JIT jit;
+    // Small morsels, so the batch is split into many of uneven sizes.
+    jit.SetBatchParallelism(4, 1000);
+    auto func = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    const size_t rows = 25'500;
+    std::vector<int64_t> arguments(rows * 2);
+    std::vector<int64_t> a(rows);
+    std::vector<int64_t> b(rows);
+    for (size_t r = 0; r < rows; r++) {
+        a[r] = arguments[r * 2] = static_cast<int64_t>(r * 7919 % 1000) - 500;
+        b[r] = arguments[r * 2 + 1] = static_cast<int64_t>(r % 13) - 6;
+    }
+    std::vector<int64_t> results(rows);
+    std::vector<uint8_t> errors(rows);
+    ASSERT_TRUE(func.CallBatch(arguments.data(), rows, results.data(), errors.data()));
+    size_t expected_selected = 0;
+    for (size_t r = 0; r < rows; r++) {
+        ASSERT_EQ(errors[r], b[r] == 0);
+        ASSERT_EQ(results[r], b[r] ? a[r] / b[r] : 0);
+        expected_selected += b[r] && a[r] / b[r];
+    }
+    std::vector<int64_t> column_results(rows);
+    const int64_t* columns[] = {a.data(), b.data()};
+    ASSERT_TRUE(func.CallColumns(columns, rows, column_results.data(), errors.data()));
+    EXPECT_EQ(column_results, results);
+
+    Aggregates aggregates;
+    ASSERT_TRUE(func.Aggregate(arguments.data(), rows, Aggregation(), aggregates));
+    EXPECT_EQ(aggregates.errors, rows / 13 + 1);
+    EXPECT_EQ(aggregates.count + aggregates.errors, rows);
+    int64_t sum = 0;
+    for (auto result : results) {
+        sum += result;
+    }
+    EXPECT_EQ(aggregates.sum, sum);
+
+    // The selection is in row order, although the morsels finish in any order.
+    std::vector<uint32_t> selection(rows);
+    size_t selected = 0;
+    ASSERT_TRUE(func.SelectColumns(columns, rows, selection.data(), selected));
+    ASSERT_EQ(selected, expected_selected);
+    size_t s = 0;
+    for (size_t r = 0; r < rows; r++) {
+        if (!errors[r] && results[r]) {
+            ASSERT_EQ(selection[s++], r);
+        }
+    }
+    EXPECT_EQ(func.GetStatistics().calls, 4 * rows);
+    EXPECT_EQ(jit.GetThreadPoolStatistics().loops, 4u);
+    EXPECT_EQ(jit.GetThreadPoolStatistics().tasks, 4u * 26);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, ParallelBatchReconfigureTest) {
+    JIT jit;
+    jit.SetBatchParallelism(4, 500);
+    auto func = jit.RegisterFunction("PARAM a; BEGIN RETURN a * 3 END.");
+    const size_t rows = 20'000;
+    std::vector<int64_t> arguments(rows);
+    for (size_t r = 0; r < rows; r++) {
+        arguments[r] = static_cast<int64_t>(r);
+    }
+    std::atomic<bool> done = false;
+    std::thread caller([&]() {
+        std::vector<int64_t> results(rows);
+        std::vector<uint8_t> errors(rows);
+        for (size_t i = 0; i < 50; i++) {
+            ASSERT_TRUE(func.CallBatch(arguments.data(), rows, results.data(), errors.data()));
+            for (size_t r = 0; r < rows; r++) {
+                ASSERT_EQ(results[r], static_cast<int64_t>(r) * 3);
+            }
+        }
+        done = true;
+    });
+    // Replacing the pool does not destroy it under the running batches.
+    for (size_t threads = 2; !done; threads = threads % 4 + 2) {
+        jit.SetBatchParallelism(threads, 500);
+        std::this_thread::yield();
+    }
+    caller.join();
+    EXPECT_EQ(func.GetStatistics().calls, 50 * rows);
+}
+//---------------------------------------------------------------------------
+TEST(JIT, AsyncTest) {
+    JIT jit;
+    jit.SetAsyncThreads(2);
+    auto func = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    // The first call compiles on the executor.
+    auto quotient = func.CallAsync({7, 2});
+    auto error = func.CallAsync({7, 0});
+    EXPECT_EQ(quotient.get(), 3);
+    EXPECT_EQ(error.get(), std::nullopt);
+    std::promise<std::optional<int64_t>> promise;
+    auto callback_result = promise.get_future();
+    func.CallAsync({-9, 3}, [&](std::optional<int64_t> value) { promise.set_value(value); });
+    EXPECT_EQ(callback_result.get(), -3);
+    // A wrong number of arguments fails like a synchronous call.
+    EXPECT_EQ(func.CallAsync({1}).get(), std::nullopt);
+
+    auto broken = jit.RegisterFunction("PARAM a; BEGIN RETURN b END.");
+    EXPECT_FALSE(broken.CompileAsync().get());
+    auto late = jit.RegisterFunction("PARAM a; BEGIN RETURN a * a END.");
+    auto compiled = late.CompileAsync();
+    // The calls submitted before the executor is replaced still run.
+    auto pending = late.CallAsync({12});
+    jit.SetAsyncThreads(1);
+    EXPECT_TRUE(compiled.get());
+    EXPECT_EQ(pending.get(), 144);
+    EXPECT_EQ(late.CallAsync({-5}).get(), 25);
+    // A callback on the executor replaces it, which cannot join its own thread.
+    std::promise<std::optional<int64_t>> replaced;
+    auto replaced_result = replaced.get_future();
+    late.CallAsync({3}, [&](std::optional<int64_t> value) {
+        jit.SetAsyncThreads(2);
+        replaced.set_value(value);
+    });
+    EXPECT_EQ(replaced_result.get(), 9);
+    EXPECT_EQ(late.CallAsync({4}).get(), 16);
+    // The retired executor is joined by a call from another thread.
+    jit.SetAsyncThreads(1);
+    EXPECT_EQ(late.CallAsync({5}).get(), 25);
+    // The call with the wrong number of arguments is not evaluated.
+    EXPECT_EQ(func.GetStatistics().calls, 3u);
+}
+//---------------------------------------------------------------------------
 } // namespace pljit
 //---------------------------------------------------------------------------
@@ -282,5 +282,83 @@ TEST(Optimization, ConstantPropagation5) {
     EXPECT_EQ(mock, optimized);
 }
 //---------------------------------------------------------------------------
+TEST(Optimization, ConstantPropagation6) {
+    {
+        const std::string code = "PARAM a;\n"
+                                 "VAR b, c;\n"
+                                 "CONST e = 2;\n"
+                                 "BEGIN\n"
+                                 "    b := e * 3;\n"
+                                 "    c := a * (b + 1);\n"
+                                 "    b := c;\n"
+                                 "    RETURN b - e\n"
+                                 "END.";
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        // Optimization Pass: Constant Propagation.
+        ConstantPropagation cp(semantic_analyzer.GetSymbolTable());
+        cp.Optimize(*ast);
+        testing::internal::CaptureStdout();
+        ASTNodeVisitorDot visitor;
+        visitor.Visit(*ast);
+    }
+    const std::string optimized = testing::internal::GetCapturedStdout();
+    {
+        // The constant sub-expressions are folded, `b` is not a constant anymore after its second assignment.
+        const std::string code = "PARAM a;\n"
+                                 "VAR b, c;\n"
+                                 "CONST e = 2;\n"
+                                 "BEGIN\n"
+                                 "    b := 6;\n"
+                                 "    c := a * 7;\n"
+                                 "    b := c;\n"
+                                 "    RETURN b - 2\n"
+                                 "END.";
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        testing::internal::CaptureStdout();
+        ASTNodeVisitorDot visitor;
+        visitor.Visit(*ast);
+    }
+    const std::string mock = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(mock, optimized);
+}
+//---------------------------------------------------------------------------
+TEST(Optimization, ConstantReturnValue) {
+    const std::vector<std::pair<std::string, std::optional<int64_t>>> codes = {
+        {"BEGIN RETURN 2 * 3 END.", 6},
+        {"PARAM a; VAR b; BEGIN b := a * 2; RETURN 1 + 2 END.", 3},
+        // The division in front of "RETURN" may fail.
+        {"PARAM a; VAR b; BEGIN b := 1 / a; RETURN 1 + 2 END.", std::nullopt},
+        {"PARAM a; BEGIN RETURN a END.", std::nullopt},
+        // Only the first "RETURN" counts.
+        {"PARAM a; BEGIN RETURN 4; RETURN a END.", 4},
+        {"PARAM a; BEGIN RETURN a; RETURN 4 END.", std::nullopt},
+    };
+    for (auto& [code, expected] : codes) {
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        // Optimization Pass: Constant Propagation.
+        ConstantPropagation cp(semantic_analyzer.GetSymbolTable());
+        cp.Optimize(*ast);
+        EXPECT_EQ(ast->GetConstantReturnValue(), expected) << code;
+    }
+}
+//---------------------------------------------------------------------------
 } // namespace pljit
 //---------------------------------------------------------------------------
@@ -0,0 +1,97 @@
+#include "parser/Parser.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "ast/ASTNodeVisitorDot.hpp"
+#include "optimization/DeadStoreElimination.hpp"
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(Optimization, DeadStoreElimination0) {
+    const std::string code = "PARAM pa;\n"
+                             "VAR va, vb;\n"
+                             "BEGIN\n"
+                             "    va := 42;\n"
+                             "    vb := pa * 2;\n"
+                             "    va := vb + 1;\n"
+                             "    vb := 1 / pa;\n"
+                             "    RETURN va\n"
+                             "END.\n";
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    ASSERT_TRUE(parse_tree);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    ASSERT_TRUE(ast);
+    // Optimization Pass: Dead Store Elimination.
+    // The first `va` is overwritten, the last `vb` is never read, but may fail.
+    DeadStoreElimination dse;
+    dse.Optimize(*ast);
+    EXPECT_TRUE(dse.HasChanged());
+    testing::internal::CaptureStdout();
+    ASTNodeVisitorDot visitor;
+    visitor.Visit(*ast);
+    const std::string expected = "digraph {\n"
+                                 "0 [label=\"Function\"];\n"
+                                 "0 -> 1\n"
+                                 "1 [label=\"Assignment \"];\n"
+                                 "1 -> 2\n"
+                                 "2 [label=\" Identifier:vb \"];\n"
+                                 "1 -> 3\n"
+                                 "3 [label=\" Binary Operator: *\"];\n"
+                                 "3 -> 4\n"
+                                 "4 [label=\" Identifier:pa \"];\n"
+                                 "3 -> 5\n"
+                                 "5 [label=\" Literal:2 \"];\n"
+                                 "0 -> 6\n"
+                                 "6 [label=\"Assignment \"];\n"
+                                 "6 -> 7\n"
+                                 "7 [label=\" Identifier:va \"];\n"
+                                 "6 -> 8\n"
+                                 "8 [label=\" Binary Operator: +\"];\n"
+                                 "8 -> 9\n"
+                                 "9 [label=\" Identifier:vb \"];\n"
+                                 "8 -> 10\n"
+                                 "10 [label=\" Literal:1 \"];\n"
+                                 "0 -> 11\n"
+                                 "11 [label=\"Assignment \"];\n"
+                                 "11 -> 12\n"
+                                 "12 [label=\" Identifier:vb \"];\n"
+                                 "11 -> 13\n"
+                                 "13 [label=\" Binary Operator: /\"];\n"
+                                 "13 -> 14\n"
+                                 "14 [label=\" Literal:1 \"];\n"
+                                 "13 -> 15\n"
+                                 "15 [label=\" Identifier:pa \"];\n"
+                                 "0 -> 16\n"
+                                 "16 [label=\"Return Statement\"];\n"
+                                 "16 -> 17\n"
+                                 "17 [label=\" Identifier:va \"];\n"
+                                 "}\n";
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), expected);
+}
+//---------------------------------------------------------------------------
+TEST(Optimization, DeadStoreElimination1) {
+    const std::string code = "PARAM pa;\n"
+                             "VAR va;\n"
+                             "BEGIN\n"
+                             "    va := pa;\n"
+                             "    va := va + 1;\n"
+                             "    RETURN va\n"
+                             "END.\n";
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    ASSERT_TRUE(parse_tree);
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    ASSERT_TRUE(ast);
+    // Optimization Pass: Dead Store Elimination. Nothing is dead.
+    DeadStoreElimination dse;
+    dse.Optimize(*ast);
+    EXPECT_FALSE(dse.HasChanged());
+    EXPECT_EQ(ast->GetChildren().size(), 3u);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
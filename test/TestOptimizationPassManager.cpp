@@ -0,0 +1,96 @@
+#include "parser/Parser.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "ast/ASTNodeVisitorDot.hpp"
+#include "optimization/PassManager.hpp"
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(Optimization, PassManagerLevels) {
+    const std::string code = "PARAM a;\n"
+                             "VAR b, c, d;\n"
+                             "CONST e = 1;\n"
+                             "BEGIN\n"
+                             "    b := 1 + 2;\n"
+                             "    c := b + e;\n"
+                             "    d := b + c + e;\n"
+                             "    RETURN a * d;\n"
+                             "    b := 3\n"
+                             "END.";
+    const std::vector<std::pair<OptimizationLevel, size_t>> levels = {
+        {OptimizationLevel::O0, 5},
+        {OptimizationLevel::O1, 4},
+        {OptimizationLevel::O2, 4},
+        {OptimizationLevel::O3, 1},
+    };
+    PassManager pass_manager;
+    for (auto& [level, statements] : levels) {
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        pass_manager.Run(PassManager::GetPipelineName(level), *ast, semantic_analyzer.GetSymbolTable());
+        EXPECT_EQ(ast->GetChildren().size(), statements);
+    }
+}
+//---------------------------------------------------------------------------
+TEST(Optimization, PassManagerFixedPoint) {
+    {
+        const std::string code = "PARAM a;\n"
+                                 "VAR b, c;\n"
+                                 "BEGIN\n"
+                                 "    b := 2;\n"
+                                 "    c := b * 3;\n"
+                                 "    RETURN a * c\n"
+                                 "END.";
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        PassManager pass_manager;
+        // The first iteration folds and removes the stores, the second one finds the fixed point.
+        EXPECT_EQ(pass_manager.Run("O3", *ast, semantic_analyzer.GetSymbolTable()), 2u);
+        testing::internal::CaptureStdout();
+        ASTNodeVisitorDot visitor;
+        visitor.Visit(*ast);
+    }
+    const std::string optimized = testing::internal::GetCapturedStdout();
+    {
+        const std::string code = "PARAM a;\n"
+                                 "VAR b, c;\n"
+                                 "BEGIN\n"
+                                 "    RETURN a * 6\n"
+                                 "END.";
+        SourceCodeManagement scm(code);
+        Parser parser(scm);
+        std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+        ASSERT_TRUE(parse_tree);
+        SemanticAnalyzer semantic_analyzer;
+        std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+        ASSERT_TRUE(ast);
+        testing::internal::CaptureStdout();
+        ASTNodeVisitorDot visitor;
+        visitor.Visit(*ast);
+    }
+    const std::string mock = testing::internal::GetCapturedStdout();
+    EXPECT_EQ(mock, optimized);
+}
+//---------------------------------------------------------------------------
+TEST(Optimization, PassManagerPipelines) {
+    PassManager pass_manager;
+    EXPECT_TRUE(pass_manager.HasPipeline("O2"));
+    EXPECT_FALSE(pass_manager.HasPipeline("fast"));
+    EXPECT_FALSE(pass_manager.AddPipeline("fast", {"unknown-pass"}));
+    EXPECT_FALSE(pass_manager.HasPipeline("fast"));
+    EXPECT_TRUE(pass_manager.AddPipeline("fast", {"constant-propagation", "dead-store-elimination"}, 2));
+    EXPECT_TRUE(pass_manager.HasPipeline("fast"));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,71 @@
+#include "jit/CodeMemory.hpp"
+#include "jit/JIT.hpp"
+#include "jit/PerfMap.hpp"
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(PerfMap, Map) {
+    const std::string path = testing::TempDir() + "pljit-test-perf.map";
+    CodeMemory code_memory;
+    uint8_t* a = code_memory.Allocate(32);
+    uint8_t* b = code_memory.Allocate(48);
+    {
+        PerfMap perf_map(PerfMap::Format::Map, path);
+        ASSERT_TRUE(perf_map.IsOpen());
+        perf_map.Register(a, 32, "first");
+        perf_map.Register(b, 48, "second");
+    }
+    std::ifstream file(path);
+    std::stringstream expected;
+    expected << std::hex << reinterpret_cast<uintptr_t>(a) << " 20 first\n" << reinterpret_cast<uintptr_t>(b) << " 30 second\n";
+    std::stringstream content;
+    content << file.rdbuf();
+    EXPECT_EQ(content.str(), expected.str());
+    std::remove(path.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(PerfMap, JitDump) {
+    const std::string path = testing::TempDir() + "pljit-test-jit.dump";
+    CodeMemory code_memory;
+    uint8_t* code = code_memory.Allocate(4);
+    std::memset(code, 0xC3, 4);
+    {
+        PerfMap perf_map(PerfMap::Format::JitDump, path);
+        ASSERT_TRUE(perf_map.IsOpen());
+        perf_map.Register(code, 4, "function");
+    }
+    std::ifstream file(path, std::ios::binary);
+    std::stringstream stream;
+    stream << file.rdbuf();
+    const std::string content = stream.str();
+    // The 40 byte header, the 56 byte record, the name and the code.
+    ASSERT_EQ(content.size(), 40u + 56u + 9u + 4u);
+    uint32_t magic;
+    std::memcpy(&magic, content.data(), sizeof(magic));
+    EXPECT_EQ(magic, 0x4A695444u);
+    uint32_t total_size;
+    std::memcpy(&total_size, content.data() + 40 + 4, sizeof(total_size));
+    EXPECT_EQ(total_size, 56u + 9u + 4u);
+    uint64_t address;
+    std::memcpy(&address, content.data() + 40 + 24, sizeof(address));
+    EXPECT_EQ(address, reinterpret_cast<uintptr_t>(code));
+    EXPECT_EQ(content.substr(40 + 56, 9), std::string("function", 9));
+    EXPECT_EQ(content.substr(40 + 56 + 9), std::string(4, '\xC3'));
+    std::remove(path.c_str());
+}
+//---------------------------------------------------------------------------
+TEST(PerfMap, FunctionNames) {
+    JIT jit;
+    auto f = jit.RegisterFunction("BEGIN RETURN 1 END.");
+    auto g = jit.RegisterFunction("BEGIN RETURN 2 END.");
+    EXPECT_EQ(f.GetName(), "pljit_function_0");
+    g.SetName("price");
+    EXPECT_EQ(g.GetName(), "price");
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
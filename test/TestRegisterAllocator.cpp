@@ -0,0 +1,99 @@
+#include "parser/Parser.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "jit/RegisterAllocator.hpp"
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Lower a function to the IR.
+static std::optional<IRFunction> Lower(const std::string& code) {
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    if (!parse_tree) { return std::nullopt; }
+    SemanticAnalyzer semantic_analyzer;
+    std::unique_ptr<FunctionAST> ast = semantic_analyzer.AnalyzeParseTree(std::move(parse_tree));
+    if (!ast) { return std::nullopt; }
+    IRBuilder builder(semantic_analyzer.GetSymbolTable(), semantic_analyzer.GetParameters());
+    return builder.Build(*ast);
+}
+//---------------------------------------------------------------------------
+/// Evaluate the function on the allocated machine registers and spill slots.
+static std::optional<int64_t> EvaluateAllocated(const IRFunction& function, const LinearScanRegisterAllocator::Allocation& allocation, const int64_t* arguments) {
+    std::vector<int64_t> registers(allocation.number_of_used_registers);
+    std::vector<int64_t> spill_slots(allocation.number_of_spill_slots);
+    auto location = [&](uint32_t virtual_register) -> int64_t& {
+        const auto& l = allocation.locations[virtual_register];
+        return l.kind == LinearScanRegisterAllocator::Location::Kind::Register ? registers[l.index] : spill_slots[l.index];
+    };
+    for (auto& instruction : function.GetInstructions()) {
+        // Read all operands before writing the destination.
+        const int64_t left = location(instruction.left);
+        const int64_t right = location(instruction.right);
+        using Opcode = Instruction::Opcode;
+        switch (instruction.opcode) {
+            case Opcode::Constant: location(instruction.destination) = instruction.value; break;
+            case Opcode::Parameter: location(instruction.destination) = arguments[instruction.value]; break;
+            case Opcode::Negate: location(instruction.destination) = -left; break;
+            case Opcode::Add: location(instruction.destination) = left + right; break;
+            case Opcode::Sub: location(instruction.destination) = left - right; break;
+            case Opcode::Mul: location(instruction.destination) = left * right; break;
+            case Opcode::Div:
+                if (right == 0) { return std::nullopt; }
+                location(instruction.destination) = left / right;
+                break;
+            case Opcode::Return: return left;
+        }
+    }
+    return std::nullopt;
+}
+//---------------------------------------------------------------------------
+static const std::string code = "PARAM a, b, c;\n"
+                                "VAR d, e, f, g;\n"
+                                "BEGIN\n"
+                                "    d := a * b + c;\n"
+                                "    e := (a - c) * (b - c) - d;\n"
+                                "    f := d * e + a * 7 - b * 11;\n"
+                                "    g := (f + e) / (d - 3) + (a + b + c + d + e + f);\n"
+                                "    RETURN g * a - f * b + e * c - d\n"
+                                "END.\n";
+//---------------------------------------------------------------------------
+TEST(RegisterAllocator, NoConflicts) {
+    auto function = Lower(code);
+    ASSERT_TRUE(function);
+    const auto intervals = LinearScanRegisterAllocator::ComputeLiveIntervals(*function);
+    for (uint32_t number_of_registers : {0u, 1u, 2u, 3u, 4u, 8u, 16u}) {
+        const auto allocation = LinearScanRegisterAllocator(number_of_registers).Allocate(*function);
+        ASSERT_EQ(allocation.locations.size(), function->GetNumberOfRegisters());
+        EXPECT_LE(allocation.number_of_used_registers, number_of_registers);
+        for (uint32_t x = 0; x < intervals.size(); x++) {
+            for (uint32_t y = x + 1; y < intervals.size(); y++) {
+                // A register may be reused by the instruction using the previous value the last time.
+                const bool overlap = intervals[x].start < intervals[y].end && intervals[y].start < intervals[x].end;
+                const auto& lx = allocation.locations[x];
+                const auto& ly = allocation.locations[y];
+                EXPECT_FALSE(overlap && lx.kind == ly.kind && lx.index == ly.index) << number_of_registers << ": " << x << " " << y;
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(RegisterAllocator, Spilling) {
+    auto function = Lower(code);
+    ASSERT_TRUE(function);
+    const auto many = LinearScanRegisterAllocator(64).Allocate(*function);
+    EXPECT_EQ(many.number_of_spill_slots, 0u);
+    const auto few = LinearScanRegisterAllocator(2).Allocate(*function);
+    EXPECT_GT(few.number_of_spill_slots, 0u);
+    EXPECT_EQ(few.number_of_used_registers, 2u);
+    for (uint32_t number_of_registers : {0u, 1u, 2u, 3u, 5u, 64u}) {
+        const auto allocation = LinearScanRegisterAllocator(number_of_registers).Allocate(*function);
+        for (int64_t a = -4; a <= 4; a++) {
+            const int64_t arguments[] = {a, a * 3 - 1, 5 - a};
+            EXPECT_EQ(EvaluateAllocated(*function, allocation, arguments), function->Evaluate(arguments)) << number_of_registers;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
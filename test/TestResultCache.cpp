@@ -0,0 +1,99 @@
+#include "jit/JIT.hpp"
+#include "jit/ResultCache.hpp"
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(ResultCache, LookupInsert) {
+    ResultCache cache(2, 64);
+    std::optional<int64_t> result;
+    const int64_t arguments0[] = {1, 2};
+    const int64_t arguments1[] = {2, 1};
+    EXPECT_FALSE(cache.Lookup(arguments0, result));
+    cache.Insert(arguments0, 3);
+    cache.Insert(arguments1, std::nullopt);
+    ASSERT_TRUE(cache.Lookup(arguments0, result));
+    EXPECT_EQ(result, 3);
+    // A cached division by zero error.
+    ASSERT_TRUE(cache.Lookup(arguments1, result));
+    EXPECT_EQ(result, std::nullopt);
+    const auto statistics = cache.GetStatistics();
+    EXPECT_EQ(statistics.hits, 2u);
+    EXPECT_EQ(statistics.misses, 1u);
+    EXPECT_TRUE(statistics.enabled);
+}
+//---------------------------------------------------------------------------
+TEST(ResultCache, Bounded) {
+    ResultCache cache(1, 64);
+    for (int64_t i = 0; i < 10000; i++) {
+        cache.Insert(&i, i * 2);
+    }
+    // Every cached result is still correct after evictions.
+    size_t cached = 0;
+    for (int64_t i = 10000 - 256; i < 10000; i++) {
+        std::optional<int64_t> result;
+        if (cache.Lookup(&i, result)) {
+            EXPECT_EQ(result, i * 2);
+            cached++;
+        }
+    }
+    EXPECT_GT(cached, 0u);
+    EXPECT_LE(cached, 64u);
+}
+//---------------------------------------------------------------------------
+TEST(ResultCache, DisabledOnLowHitRate) {
+    ResultCache cache(1, 64);
+    // Only distinct arguments: the cache never hits.
+    for (int64_t i = 0; i < static_cast<int64_t>(ResultCache::window_size); i++) {
+        std::optional<int64_t> result;
+        EXPECT_FALSE(cache.Lookup(&i, result));
+        cache.Insert(&i, i);
+    }
+    EXPECT_FALSE(cache.IsEnabled());
+    EXPECT_FALSE(cache.GetStatistics().enabled);
+}
+//---------------------------------------------------------------------------
+TEST(ResultCache, JIT) {
+    const std::string code = "PARAM a, b;\n"
+                             "BEGIN\n"
+                             "    RETURN (a * 10) / b\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    EXPECT_EQ(func.GetResultCacheStatistics().hits, 0u);
+    ASSERT_TRUE(func.EnableResultCache());
+    auto call_all = [&func]() {
+        for (int64_t a = 0; a < 100; a++) {
+            EXPECT_EQ(func(a, a % 10 + 1), a * 10 / (a % 10 + 1));
+        }
+    };
+    // A single-threaded pass caches the results, so the concurrent passes only hit. Concurrent first calls of a key may all miss.
+    call_all();
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < 7; i++) {
+        threads.emplace_back(call_all);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(func(1, 0), std::nullopt);
+    EXPECT_EQ(func(1, 0), std::nullopt);
+    const auto statistics = func.GetResultCacheStatistics();
+    EXPECT_EQ(statistics.hits + statistics.misses, 8u * 100u + 2u);
+    EXPECT_GE(statistics.hits, 7u * 100u);
+    EXPECT_TRUE(statistics.enabled);
+}
+//---------------------------------------------------------------------------
+TEST(ResultCache, JITCompilationError) {
+    const std::string code = "BEGIN\n"
+                             "    RETURN a\n"
+                             "END.\n";
+    JIT jit;
+    auto func = jit.RegisterFunction(code);
+    EXPECT_FALSE(func.EnableResultCache());
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
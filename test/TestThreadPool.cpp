@@ -0,0 +1,69 @@
+#include "util/ThreadPool.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(ThreadPool, EveryTaskOnce) {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.GetNumberOfThreads(), 4u);
+    for (size_t number_of_tasks : {0u, 1u, 3u, 100u, 1000u}) {
+        std::vector<std::atomic<size_t>> runs(number_of_tasks);
+        pool.ParallelFor(number_of_tasks, [&](size_t task, size_t thread) {
+            ASSERT_LT(thread, 4u);
+            runs[task]++;
+        });
+        for (auto& count : runs) {
+            ASSERT_EQ(count, 1u);
+        }
+    }
+    EXPECT_EQ(pool.GetStatistics().loops, 4u);
+    EXPECT_EQ(pool.GetStatistics().tasks, 1104u);
+}
+//---------------------------------------------------------------------------
+TEST(ThreadPool, UnevenTasks) {
+    ThreadPool pool(4);
+    // The first thread's range holds all the slow tasks, the others have to steal them.
+    std::vector<std::atomic<size_t>> runs(64);
+    pool.ParallelFor(runs.size(), [&](size_t task, size_t) {
+        if (task < 16) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        runs[task]++;
+    });
+    for (auto& count : runs) {
+        ASSERT_EQ(count, 1u);
+    }
+    EXPECT_GT(pool.GetStatistics().steals, 0u);
+}
+//---------------------------------------------------------------------------
+TEST(ThreadPool, Nested) {
+    ThreadPool pool(3);
+    std::atomic<size_t> inner_tasks = 0;
+    pool.ParallelFor(6, [&](size_t, size_t) {
+        // The nested loop runs on the calling thread.
+        const auto id = std::this_thread::get_id();
+        pool.ParallelFor(5, [&](size_t, size_t thread) {
+            EXPECT_EQ(thread, 0u);
+            EXPECT_EQ(std::this_thread::get_id(), id);
+            inner_tasks++;
+        });
+    });
+    EXPECT_EQ(inner_tasks, 30u);
+}
+//---------------------------------------------------------------------------
+TEST(ThreadPool, SingleThread) {
+    ThreadPool pool(1);
+    std::vector<size_t> order;
+    pool.ParallelFor(5, [&](size_t task, size_t thread) {
+        EXPECT_EQ(thread, 0u);
+        order.push_back(task);
+    });
+    EXPECT_EQ(order, (std::vector<size_t>{0, 1, 2, 3, 4}));
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
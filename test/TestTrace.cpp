@@ -0,0 +1,85 @@
+#include "jit/JIT.hpp"
+#include "util/Trace.hpp"
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+TEST(Trace, Write) {
+    TraceRecorder recorder(2);
+    {
+        TraceSpan span(&recorder, "first", "test", "function \"f\"");
+        TraceSpan disabled(nullptr, "disabled", "test");
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    recorder.Record("second", "test", "", begin, begin + std::chrono::nanoseconds(1500));
+    recorder.Record("dropped", "test", "", begin, begin);
+    EXPECT_EQ(recorder.GetEvents().size(), 2u);
+    EXPECT_EQ(recorder.GetDroppedEvents(), 1u);
+    std::stringstream out;
+    recorder.Write(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"first\",\"cat\":\"test\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"function\":\"function \\\"f\\\"\"}"), std::string::npos);
+    EXPECT_NE(json.find("\"dur\":1.500"), std::string::npos);
+}
+//---------------------------------------------------------------------------
+TEST(Trace, JIT) {
+    const std::string code = "PARAM a;\n"
+                             "VAR b;\n"
+                             "BEGIN\n"
+                             "    b := 2 * 3;\n"
+                             "    RETURN a * b\n"
+                             "END.\n";
+    TraceRecorder recorder;
+    JIT jit;
+    jit.SetTraceRecorder(&recorder);
+    auto func = jit.RegisterFunction(code, OptimizationLevel::O3);
+    func.SetName("scale");
+    std::thread thread([&func]() { EXPECT_EQ(func(1), 6); });
+    thread.join();
+    EXPECT_EQ(func(2), 12);
+    std::multiset<std::string> names;
+    std::set<uint32_t> thread_ids;
+    for (auto& event : recorder.GetEvents()) {
+        names.insert(event.name);
+        thread_ids.insert(event.thread_id);
+        EXPECT_EQ(event.function, event.category == "call" ? "" : "scale");
+    }
+    EXPECT_EQ(names.count("scale"), 2u);
+    EXPECT_EQ(names.count("compile"), 1u);
+    EXPECT_EQ(names.count("lex+parse"), 1u);
+    EXPECT_EQ(names.count("semantic-analysis"), 1u);
+    EXPECT_EQ(names.count("optimization"), 1u);
+    EXPECT_GE(names.count("constant-propagation"), 1u);
+    EXPECT_EQ(thread_ids.size(), 2u);
+}
+//---------------------------------------------------------------------------
+TEST(Trace, Batch) {
+    TraceRecorder recorder;
+    JIT jit;
+    jit.SetTraceRecorder(&recorder);
+    auto func = jit.RegisterFunction("PARAM a, b; BEGIN RETURN a / b END.");
+    // A name longer than the small string buffer, so it lives on the heap.
+    const std::string name = "a function with a name longer than the small string buffer";
+    func.SetName(name);
+    const std::vector<int64_t> arguments = {6, 3, 1, 0};
+    std::vector<int64_t> results(2);
+    std::vector<uint8_t> errors(2);
+    ASSERT_TRUE(func.CallBatch(arguments.data(), 2, results.data(), errors.data()));
+    size_t batches = 0;
+    for (auto& event : recorder.GetEvents()) {
+        if (event.category == "batch") {
+            EXPECT_EQ(event.name, name);
+            batches++;
+        }
+    }
+    EXPECT_EQ(batches, 1u);
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------
@@ -0,0 +1,80 @@
+#include "jit/JIT.hpp"
+#include "parser/Parser.hpp"
+#include "ast/SemanticAnalyzer.hpp"
+#include "util/WorkloadGenerator.hpp"
+#include <gtest/gtest.h>
+//---------------------------------------------------------------------------
+namespace pljit {
+//---------------------------------------------------------------------------
+/// Check if the code is a valid function.
+static bool IsValid(const std::string& code) {
+    SourceCodeManagement scm(code);
+    Parser parser(scm);
+    std::unique_ptr<NonTerminalParseTreeNode> parse_tree = parser.ParseFunctionDefinition();
+    if (!parse_tree) { return false; }
+    SemanticAnalyzer semantic_analyzer;
+    return semantic_analyzer.AnalyzeParseTree(std::move(parse_tree)) != nullptr;
+}
+//---------------------------------------------------------------------------
+TEST(WorkloadGenerator, Reproducible) {
+    WorkloadGenerator a(42);
+    WorkloadGenerator b(42);
+    WorkloadGenerator c(43);
+    const std::string code = a.Generate();
+    EXPECT_EQ(code, b.Generate());
+    EXPECT_NE(code, c.Generate());
+    EXPECT_NE(code, a.Generate());
+}
+//---------------------------------------------------------------------------
+TEST(WorkloadGenerator, Valid) {
+    for (uint64_t seed = 0; seed < 50; seed++) {
+        WorkloadGenerator::Options options;
+        options.number_of_parameters = seed % 4;
+        options.number_of_variables = seed % 5;
+        options.number_of_constants = seed % 3;
+        options.number_of_statements = seed % 20;
+        options.max_expression_depth = seed % 6;
+        options.division_percent = static_cast<uint32_t>(seed % 3) * 20;
+        options.constant_density_percent = static_cast<uint32_t>(seed % 4) * 30;
+        options.mul_weight = static_cast<uint32_t>(seed % 2);
+        WorkloadGenerator generator(seed, options);
+        for (size_t i = 0; i < 4; i++) {
+            const std::string code = generator.Generate();
+            EXPECT_TRUE(IsValid(code)) << code;
+        }
+    }
+}
+//---------------------------------------------------------------------------
+TEST(WorkloadGenerator, Large) {
+    WorkloadGenerator::Options options;
+    options.number_of_parameters = 8;
+    options.number_of_variables = 64;
+    options.number_of_constants = 16;
+    options.number_of_statements = 10000;
+    WorkloadGenerator generator(7, options);
+    EXPECT_TRUE(IsValid(generator.Generate()));
+}
+//---------------------------------------------------------------------------
+TEST(WorkloadGenerator, DifferentialOptimization) {
+    // The optimizations must not change the results, including the division by zero errors.
+    WorkloadGenerator::Options options;
+    options.number_of_parameters = 2;
+    options.number_of_statements = 12;
+    options.division_percent = 25;
+    options.max_literal = 5;
+    WorkloadGenerator generator(2024, options);
+    JIT jit;
+    for (size_t i = 0; i < 50; i++) {
+        const std::string code = generator.Generate();
+        auto o0 = jit.RegisterFunction(code, OptimizationLevel::O0);
+        auto o3 = jit.RegisterFunction(code, OptimizationLevel::O3);
+        for (int64_t a = -2; a <= 2; a++) {
+            for (int64_t b = -2; b <= 2; b++) {
+                EXPECT_EQ(o0(a, b), o3(a, b)) << code << a << " " << b;
+            }
+        }
+    }
+}
+//---------------------------------------------------------------------------
+} // namespace pljit
+//---------------------------------------------------------------------------